@@ -0,0 +1,109 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <iostream>
+#include "shared/application/BatchRunner.h"
+#include "shared/infrastructure/TaskScheduler.h"
+
+// Headless entry point: yoloBatch [options] <video|image|directory>...
+int main(int argc, char *argv[])
+{
+    // Same runtime thread budget as the GUI (see main.cpp)
+    qputenv("OMP_NUM_THREADS", QByteArray::number(TaskScheduler::runtimeThreadBudget()));
+    qputenv("KMP_BLOCKTIME", "1");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("yoloBatch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs YOLO over video files and image directories as fast as possible "
+                                     "and writes per-frame detections.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Video files, image files or directories of images.", "<input>...");
+
+    QCommandLineOption taskOption({"t", "task"}, "detection, pose or segmentation (default detection).", "task", "detection");
+    QCommandLineOption runtimeOption({"r", "runtime"}, "openvino or onnx (default openvino).", "runtime", "openvino");
+    QCommandLineOption modelOption({"m", "model"}, "Model file; defaults to the bundled one for the task and runtime.", "path");
+    QCommandLineOption outputOption({"o", "output"}, "Output file, - for stdout (default).", "path", "-");
+    QCommandLineOption formatOption({"f", "format"}, "jsonl or csv (default jsonl).", "format", "jsonl");
+    QCommandLineOption hintOption("hint", "throughput or latency (default throughput).", "hint", "throughput");
+    QCommandLineOption streamsOption("streams", "OpenVINO throughput streams, 0 = plugin default.", "n", "0");
+    QCommandLineOption confOption("conf", "Confidence threshold.", "value", "0.4");
+    QCommandLineOption iouOption("iou", "NMS IoU threshold.", "value", "0.5");
+    QCommandLineOption nmsOption("nms", "greedy or grid (default greedy; grid suits crowded scenes).", "mode", "greedy");
+    QCommandLineOption perClassOption("nms-per-class", "Only suppress boxes of the same class.");
+    QCommandLineOption maxCandidatesOption("max-candidates", "Best anchors kept before NMS, 0 = all (default 3000).", "n", "3000");
+    QCommandLineOption maxDetectionsOption("max-det", "Detections kept per frame, 0 = all (default 300).", "n", "300");
+    parser.addOptions({taskOption, runtimeOption, modelOption, outputOption, formatOption,
+                       hintOption, streamsOption, confOption, iouOption, nmsOption, perClassOption,
+                       maxCandidatesOption, maxDetectionsOption});
+    parser.process(app);
+
+    auto fail = [](const QString& message) {
+        std::cerr << "[Batch]: " << message.toStdString() << std::endl;
+        return 2;
+    };
+
+    // Numeric options: false if the value is not a number in range
+    auto parseCount = [&parser](const QCommandLineOption& option, int& out) {
+        bool ok = false;
+        out = parser.value(option).toInt(&ok);
+        return ok && out >= 0;
+    };
+    auto parseFraction = [&parser](const QCommandLineOption& option, float& out) {
+        bool ok = false;
+        out = parser.value(option).toFloat(&ok);
+        return ok && out >= 0.0f && out <= 1.0f;
+    };
+
+    BatchOptions options;
+    options.inputs = parser.positionalArguments();
+    if (options.inputs.isEmpty()) return fail("No inputs given (see --help).");
+
+    InferenceConfig& config = options.inference;
+    const QString task = parser.value(taskOption).toLower();
+    if (task == "detection") config.taskType = YoloTask::TaskType::ObjectDetection;
+    else if (task == "pose") config.taskType = YoloTask::TaskType::PoseEstimation;
+    else if (task == "segmentation") config.taskType = YoloTask::TaskType::ImageSegmentation;
+    else return fail("Unknown task " + task);
+
+    const QString runtime = parser.value(runtimeOption).toLower();
+    if (runtime == "openvino") config.runtimeType = YoloTask::RuntimeType::OpenVINO;
+    else if (runtime == "onnx") config.runtimeType = YoloTask::RuntimeType::ONNXRuntime;
+    else return fail("Unknown runtime " + runtime);
+
+    const QString hint = parser.value(hintOption).toLower();
+    if (hint == "throughput") config.performanceHint = YoloTask::PerformanceHint::Throughput;
+    else if (hint == "latency") config.performanceHint = YoloTask::PerformanceHint::Latency;
+    else return fail("Unknown hint " + hint);
+
+    const QString nms = parser.value(nmsOption).toLower();
+    if (nms == "greedy") config.nmsMode = YoloTask::NmsMode::Greedy;
+    else if (nms == "grid") config.nmsMode = YoloTask::NmsMode::Grid;
+    else return fail("Unknown NMS mode " + nms);
+    config.classAgnosticNms = !parser.isSet(perClassOption);
+    if (!parseCount(maxCandidatesOption, config.maxCandidates))
+        return fail("Invalid --max-candidates " + parser.value(maxCandidatesOption) + " (expected a count >= 0)");
+    if (!parseCount(maxDetectionsOption, config.maxDetections))
+        return fail("Invalid --max-det " + parser.value(maxDetectionsOption) + " (expected a count >= 0)");
+
+    const QString format = parser.value(formatOption).toLower();
+    if (format == "jsonl") options.format = DetectionWriter::Format::JsonLines;
+    else if (format == "csv") options.format = DetectionWriter::Format::Csv;
+    else return fail("Unknown format " + format);
+
+    config.modelPath = parser.isSet(modelOption) ? parser.value(modelOption).toStdString()
+                                                 : defaultModelPath(config.taskType, config.runtimeType);
+    if (!parseCount(streamsOption, config.numStreams))
+        return fail("Invalid --streams " + parser.value(streamsOption) + " (expected a count >= 0)");
+    if (!parseFraction(confOption, config.confidenceThreshold))
+        return fail("Invalid --conf " + parser.value(confOption) + " (expected a value in [0, 1])");
+    if (!parseFraction(iouOption, config.iouThreshold))
+        return fail("Invalid --iou " + parser.value(iouOption) + " (expected a value in [0, 1])");
+    config.intraOpThreads = TaskScheduler::runtimeThreadBudget();
+    options.output = parser.value(outputOption);
+
+    TaskScheduler::global().installOpenCvBackend();
+
+    BatchRunner runner(std::move(options));
+    return runner.run();
+}
@@ -3,10 +3,14 @@
 #include <QCoreApplication>
 #include <QVideoFrameFormat>
 #include <QColor>
+#include <algorithm>
 #include <chrono>
 #include <QDebug>
 #include "../../shared/domain/UiLogger.h"
 #include "../infrastructure/OpenCVVideoFileSource.h"
+#include "../../../shared/infrastructure/TaskScheduler.h"
+#include "../../../shared/infrastructure/ThreadNames.h"
+#include "../../../shared/infrastructure/Tracer.h"
 
 CaptureWorker::CaptureWorker(ICaptureSource *source, QObject *parent)
     : QObject(parent)
@@ -24,6 +28,7 @@ void CaptureWorker::startCapturing(QVideoSink* sink)
     if (m_running) return;
     m_running = true;
     m_sink = sink;
+    ThreadNames::setCurrent("capture");
 
     SourceConfig config;
     {
@@ -60,8 +65,23 @@ void CaptureWorker::startCapturing(QVideoSink* sink)
             startTime = std::chrono::high_resolution_clock::now();
         }
 
-        // Sync logic for Video File mode
-        if (config.sourceType == InputSourceType::VideoFile) {
+        const FrameRing::Policy handoff = m_frameRing ? m_frameRing->policy() : FrameRing::Policy::LatestWins;
+
+        // Rate limited: pull frames off the camera but only decode the ones inference can take
+        if (m_captureRateLimit > 0.0 && config.sourceType == InputSourceType::LiveCamera) {
+            auto steadyNow = std::chrono::steady_clock::now();
+            if (steadyNow < m_nextDecodeTime) {
+                std::lock_guard<std::mutex> lock(m_sourceMutex);
+                if (m_source && m_source->skipFrame()) continue;
+            } else {
+                auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(1.0 / m_captureRateLimit));
+                m_nextDecodeTime = std::max(m_nextDecodeTime + period, steadyNow);
+            }
+        }
+
+        // Sync logic for Video File mode; every frame is kept under bounded FIFO
+        if (config.sourceType == InputSourceType::VideoFile && handoff != FrameRing::Policy::BoundedFifo) {
             auto* fileSource = dynamic_cast<OpenCVVideoFileSource*>(m_source);
             if (fileSource) {
                 int64_t total = fileSource->frameCount();
@@ -85,13 +105,19 @@ void CaptureWorker::startCapturing(QVideoSink* sink)
             }
         }
 
-        cv::Mat& currentFrame = m_framePool[m_poolIndex];
+        // Decode straight into a pooled buffer; inference and display share it by reference
+        FrameRef frameRef = m_framePool.acquire();
+        cv::Mat& currentFrame = *frameRef;
+        FrameTrace trace;
         {
+            YOLO_TRACE_SCOPE("capture.read");
             std::lock_guard<std::mutex> lock(m_sourceMutex);
             if (!m_source || !m_source->readFrame(currentFrame) || currentFrame.empty()) {
                 QThread::msleep(10);
                 continue;
             }
+            trace.frameId = ++m_nextFrameId;
+            trace.mark(FrameTrace::Captured);
             if (config.sourceType == InputSourceType::VideoFile) {
                 m_videoFramesRead = m_source->currentFrameIndex();
                 auto* fileSource = dynamic_cast<OpenCVVideoFileSource*>(m_source);
@@ -103,62 +129,20 @@ void CaptureWorker::startCapturing(QVideoSink* sink)
         }
 
         bool isImage = (config.sourceType == InputSourceType::ImageFile);
-        if (m_inferenceProcessingFlag && !m_inferenceProcessingFlag->load(std::memory_order_relaxed)) {
-            if (!isImage || m_needsStaticInference.load()) {
-                auto shared = std::make_shared<cv::Mat>(currentFrame.clone());
-                emit frameReady(shared);
-                m_needsStaticInference = false;
-            }
+        if (m_frameRing && (!isImage || m_needsStaticInference.load())) {
+            if (publishFrame(frameRef, trace)) m_needsStaticInference = false;
         }
 
         std::shared_ptr<std::vector<DetectionResult>> currentDetections;
+        FrameTrace detectionsTrace;
         {
             std::lock_guard<std::mutex> lock(m_detectionsMutex);
             currentDetections = m_latestDetections;
-        }
-
-        if (currentDetections) {
-            for (const auto& det : *currentDetections) {
-                if (!det.boxMask.empty()) {
-                    cv::Rect originalBox = det.box;
-                    cv::Rect displayBox = originalBox & cv::Rect(0, 0, currentFrame.cols, currentFrame.rows);
-                    if (displayBox.width > 0 && displayBox.height > 0) {
-                        int dx = displayBox.x - originalBox.x;
-                        int dy = displayBox.y - originalBox.y;
-                        cv::Rect maskRoi(dx, dy, displayBox.width, displayBox.height);
-                        maskRoi = maskRoi & cv::Rect(0, 0, det.boxMask.cols, det.boxMask.rows);
-                        
-                        if (maskRoi.width > 0 && maskRoi.height > 0) {
-                            cv::Mat roi = currentFrame(displayBox);
-                            int hue = (det.classId * 60) % 360;
-                            QColor color = QColor::fromHsl(hue, 255, 127);
-                            int b = color.blue();
-                            int g = color.green();
-                            int r = color.red();
-                            
-                            cv::Mat activeMask = det.boxMask(maskRoi);
-                            if (activeMask.size() != roi.size()) {
-                                cv::resize(activeMask, activeMask, roi.size());
-                            }
-
-                            for (int y = 0; y < roi.rows; ++y) {
-                                uchar* pRoi = roi.ptr<uchar>(y);
-                                const uchar* pMask = activeMask.ptr<uchar>(y);
-                                for (int x = 0; x < roi.cols; ++x) {
-                                    if (pMask[x] > 128) {
-                                        pRoi[x*3+0] = (pRoi[x*3+0] + b) >> 1;
-                                        pRoi[x*3+1] = (pRoi[x*3+1] + g) >> 1;
-                                        pRoi[x*3+2] = (pRoi[x*3+2] + r) >> 1;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+            detectionsTrace = m_latestTrace;
         }
 
         if (m_sink) {
+            YOLO_TRACE_SCOPE("capture.present");
             QVideoFrame& frame = m_reusableFrames[m_reusableFrameIndex];
             if (frame.map(QVideoFrame::WriteOnly)) {
                 cv::Mat resizedFrame = currentFrame;
@@ -176,14 +160,24 @@ void CaptureWorker::startCapturing(QVideoSink* sink)
                 } else if (resizedFrame.channels() == 1) {
                     cv::cvtColor(resizedFrame, wrapper, cv::COLOR_GRAY2RGBA);
                 }
+
+                // Masks go onto the display copy; the shared frame stays untouched for inference
+                if (currentDetections) {
+                    blendMasks(wrapper, currentFrame.size(), *currentDetections);
+                }
                 
                 frame.unmap();
                 m_sink->setVideoFrame(frame);
+
+                if (currentDetections && detectionsTrace.frameId != m_lastPresentedId) {
+                    m_lastPresentedId = detectionsTrace.frameId;
+                    detectionsTrace.mark(FrameTrace::Presented);
+                    emit detectionsPresented(detectionsTrace);
+                }
             }
             m_reusableFrameIndex = (m_reusableFrameIndex + 1) % 2;
         }
-        
-        m_poolIndex = (m_poolIndex + 1) % 3;
+        frameRef.reset();
 
         if (config.sourceType != InputSourceType::ImageFile) {
             frames++;
@@ -194,6 +188,16 @@ void CaptureWorker::startCapturing(QVideoSink* sink)
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
         if (duration >= 1000) {
             emit fpsUpdated(frames * 1000.0 / duration);
+            FramePool::Stats pool = m_framePool.stats();
+            emit framePoolStatsUpdated(pool.inUse, pool.capacity, pool.peakInUse, pool.starved);
+            if (m_frameRing) {
+                FrameRing::Stats ring = m_frameRing->stats();
+                if (handoff == FrameRing::Policy::AdaptiveRate && config.sourceType == InputSourceType::LiveCamera) {
+                    adaptCaptureRate(ring, duration / 1000.0, config.fps);
+                }
+                m_lastHandoff = ring;
+                emit handoffStatsUpdated(ring.consumed, ring.dropped, ring.stale, m_captureRateLimit);
+            }
             frames = 0;
             startTime = now;
         }
@@ -248,8 +252,9 @@ bool CaptureWorker::openSource(const SourceConfig& config) {
     m_reusableFrames[0] = QVideoFrame(format);
     m_reusableFrames[1] = QVideoFrame(format);
 
-    for(int i=0; i<3; ++i) m_framePool[i] = cv::Mat();
+    m_framePool.trim();
     clearDetections();
+    m_captureRateLimit = 0.0;
 
     // Reset sync state
     m_videoStartTime = std::chrono::high_resolution_clock::now();
@@ -261,6 +266,110 @@ bool CaptureWorker::openSource(const SourceConfig& config) {
     return true;
 }
 
+bool CaptureWorker::publishFrame(const FrameRef& frame, const FrameTrace& trace)
+{
+    // Hand over a reference. Under bounded FIFO wait for inference to free a slot,
+    // otherwise the ring drops an unread older frame to make room.
+    int slot = m_frameRing->beginWrite();
+    while (slot < 0) {
+        if (!m_running || m_configUpdatePending.load()) return false;
+        m_frameRing->waitForSpace(std::chrono::milliseconds(5));
+        QCoreApplication::processEvents();
+        slot = m_frameRing->beginWrite();
+    }
+    m_frameRing->frame(slot) = frame;
+    m_frameRing->trace(slot) = trace;
+    m_frameRing->trace(slot).mark(FrameTrace::Published);
+    m_frameRing->publish(slot);
+    return true;
+}
+
+void CaptureWorker::adaptCaptureRate(const FrameRing::Stats& handoff, double seconds, double sourceFps)
+{
+    if (seconds <= 0.0) return;
+    const double consumedFps = (handoff.consumed - m_lastHandoff.consumed) / seconds;
+    const uint64_t dropped = handoff.dropped - m_lastHandoff.dropped;
+    const uint64_t published = handoff.published - m_lastHandoff.published;
+
+    if (published > 0 && dropped * 10 > published) {
+        // More than a tenth of the decoded frames were never inferred: follow
+        // inference with a little headroom so the ring still has a fresh frame
+        double limit = std::max(AppConfig::MinCaptureFps, consumedFps * 1.15);
+        if (m_captureRateLimit == 0.0 || limit < m_captureRateLimit) {
+            m_captureRateLimit = limit;
+        }
+    } else if (m_captureRateLimit > 0.0 && dropped == 0) {
+        // Keeping up; probe upwards until the source runs unthrottled again
+        m_captureRateLimit *= 1.25;
+        if (sourceFps > 0.0 && m_captureRateLimit >= sourceFps) m_captureRateLimit = 0.0;
+    }
+}
+
+void CaptureWorker::blendMasks(cv::Mat& rgba, const cv::Size& sourceSize,
+                               const std::vector<DetectionResult>& detections)
+{
+    YOLO_TRACE_SCOPE("capture.blend");
+    if (sourceSize.width <= 0 || sourceSize.height <= 0) return;
+    const double sx = static_cast<double>(rgba.cols) / sourceSize.width;
+    const double sy = static_cast<double>(rgba.rows) / sourceSize.height;
+
+    struct Overlay {
+        cv::Rect displayBox;
+        cv::Mat mask;
+        int r, g, b;
+    };
+    std::vector<Overlay> overlays;
+
+    for (const auto& det : detections) {
+        if (det.boxMask.empty()) continue;
+
+        cv::Rect originalBox = det.box;
+        cv::Rect sourceBox = originalBox & cv::Rect(0, 0, sourceSize.width, sourceSize.height);
+        if (sourceBox.width <= 0 || sourceBox.height <= 0) continue;
+
+        int dx = sourceBox.x - originalBox.x;
+        int dy = sourceBox.y - originalBox.y;
+        cv::Rect maskRoi(dx, dy, sourceBox.width, sourceBox.height);
+        maskRoi = maskRoi & cv::Rect(0, 0, det.boxMask.cols, det.boxMask.rows);
+        if (maskRoi.width <= 0 || maskRoi.height <= 0) continue;
+
+        cv::Rect displayBox(cvRound(sourceBox.x * sx), cvRound(sourceBox.y * sy),
+                            cvRound(sourceBox.width * sx), cvRound(sourceBox.height * sy));
+        displayBox &= cv::Rect(0, 0, rgba.cols, rgba.rows);
+        if (displayBox.width <= 0 || displayBox.height <= 0) continue;
+
+        int hue = (det.classId * 60) % 360;
+        QColor color = QColor::fromHsl(hue, 255, 127);
+
+        cv::Mat activeMask = det.boxMask(maskRoi);
+        if (activeMask.size() != displayBox.size()) {
+            cv::resize(activeMask, activeMask, displayBox.size());
+        }
+        overlays.push_back({displayBox, activeMask, color.red(), color.green(), color.blue()});
+    }
+    if (overlays.empty()) return;
+
+    // Row bands on the shared scheduler; within a band masks are applied in
+    // detection order, so overlapping masks blend the same as serially
+    TaskScheduler::global().parallelFor(0, rgba.rows, 32, [&](int rowBegin, int rowEnd) {
+        for (const Overlay& o : overlays) {
+            int y0 = std::max(rowBegin, o.displayBox.y);
+            int y1 = std::min(rowEnd, o.displayBox.y + o.displayBox.height);
+            for (int y = y0; y < y1; ++y) {
+                uchar* pRoi = rgba.ptr<uchar>(y) + o.displayBox.x * 4;
+                const uchar* pMask = o.mask.ptr<uchar>(y - o.displayBox.y);
+                for (int x = 0; x < o.displayBox.width; ++x) {
+                    if (pMask[x] > 128) {
+                        pRoi[x*4+0] = (pRoi[x*4+0] + o.r) >> 1;
+                        pRoi[x*4+1] = (pRoi[x*4+1] + o.g) >> 1;
+                        pRoi[x*4+2] = (pRoi[x*4+2] + o.b) >> 1;
+                    }
+                }
+            }
+        }
+    });
+}
+
 void CaptureWorker::stopCapturing() {
     m_running = false;
 }
@@ -317,13 +426,16 @@ void CaptureWorker::setSource(ICaptureSource* source, const SourceConfig& config
     m_configUpdatePending = true;
 }
 
-void CaptureWorker::updateLatestDetections(std::shared_ptr<std::vector<DetectionResult>> detections, const QSize& frameSize) {
+void CaptureWorker::updateLatestDetections(std::shared_ptr<std::vector<DetectionResult>> detections, const QSize& frameSize,
+                                           const FrameTrace& trace) {
     Q_UNUSED(frameSize);
     std::lock_guard<std::mutex> lock(m_detectionsMutex);
     m_latestDetections = detections;
+    m_latestTrace = trace;
 }
 
 void CaptureWorker::clearDetections() {
     std::lock_guard<std::mutex> lock(m_detectionsMutex);
     m_latestDetections.reset();
+    m_latestTrace = FrameTrace();
 }
@@ -11,6 +11,10 @@
 #include <opencv2/opencv.hpp>
 #include "../domain/ICaptureSource.h"
 #include "../../detection/domain/DetectionResult.h"
+#include "../../../shared/infrastructure/FramePool.h"
+#include "../../../shared/infrastructure/FrameRing.h"
+#include "../../../shared/domain/AppConfig.h"
+#include "../../../shared/domain/FrameTrace.h"
 
 class CaptureWorker : public QObject {
     Q_OBJECT
@@ -19,11 +23,14 @@ public:
     explicit CaptureWorker(ICaptureSource *source, QObject *parent = nullptr);
     ~CaptureWorker() override;
 
-    void setInferenceProcessingFlag(std::atomic<bool>* flag) { m_inferenceProcessingFlag = flag; }
+    void setFrameRing(FrameRing* ring) { m_frameRing = ring; }
 
 signals:
-    void frameReady(std::shared_ptr<cv::Mat> frame); 
     void fpsUpdated(double fps);
+    void framePoolStatsUpdated(int inUse, int capacity, int peakInUse, quint64 starved);
+    void handoffStatsUpdated(quint64 processed, quint64 dropped, quint64 stale, double rateLimit);
+    // Detections of a frame reached the screen for the first time
+    void detectionsPresented(const FrameTrace& trace);
     void resolutionChanged(QSize size);
     void metadataUpdated(double fps, int64_t totalFrames);
     void progressUpdated(int64_t frame);
@@ -32,7 +39,8 @@ signals:
 public slots:
     void startCapturing(QVideoSink* sink);
     void stopCapturing();
-    void updateLatestDetections(std::shared_ptr<std::vector<DetectionResult>> detections, const QSize& frameSize);
+    void updateLatestDetections(std::shared_ptr<std::vector<DetectionResult>> detections, const QSize& frameSize,
+                                const FrameTrace& trace);
     void clearDetections();
     void updateResolution(const QSize& size);
     void setSource(ICaptureSource* source, const SourceConfig& config);
@@ -45,18 +53,20 @@ private:
     std::mutex m_sourceMutex;
 
     std::atomic<bool> m_running{false};
-    std::atomic<bool>* m_inferenceProcessingFlag = nullptr;
+    FrameRing* m_frameRing = nullptr;
     QVideoSink* m_sink = nullptr;
 
     std::mutex m_detectionsMutex;
     std::shared_ptr<std::vector<DetectionResult>> m_latestDetections;
+    FrameTrace m_latestTrace;
+    uint64_t m_lastPresentedId = 0; // capture thread only
+    uint64_t m_nextFrameId = 0;     // capture thread only
 
     std::mutex m_configMutex;
     SourceConfig m_requestedConfig;
     std::atomic<bool> m_configUpdatePending{false};
 
-    cv::Mat m_framePool[3]; 
-    int m_poolIndex = 0;
+    FramePool m_framePool{AppConfig::FramePoolSize};
     
     QVideoFrame m_reusableFrames[2];
     int m_reusableFrameIndex = 0;
@@ -66,5 +76,14 @@ private:
     int64_t m_videoFramesRead = 0;
     bool m_isFirstFrame = true;
 
+    // Adaptive capture rate (FrameRing::Policy::AdaptiveRate), 0 = unlimited
+    double m_captureRateLimit = 0.0;
+    std::chrono::steady_clock::time_point m_nextDecodeTime;
+    FrameRing::Stats m_lastHandoff;
+
     bool openSource(const SourceConfig& config);
+    bool publishFrame(const FrameRef& frame, const FrameTrace& trace);
+    void adaptCaptureRate(const FrameRing::Stats& handoff, double seconds, double sourceFps);
+    static void blendMasks(cv::Mat& rgba, const cv::Size& sourceSize,
+                           const std::vector<DetectionResult>& detections);
 };
@@ -43,6 +43,32 @@ void YoloCameraController::updateFps(double fps)
     }
 }
 
+void YoloCameraController::updateFramePoolStats(int inUse, int capacity, int peakInUse, quint64 starved)
+{
+    if (starved > m_framePoolStarved) {
+        UiLogger::ctrl("YoloCameraController: Frame pool starved " + QString::number(starved - m_framePoolStarved)
+                       + "x (" + QString::number(capacity) + " buffers)");
+    }
+    m_framePoolInUse = inUse;
+    m_framePoolSize = capacity;
+    m_framePoolPeak = peakInUse;
+    m_framePoolStarved = starved;
+    emit framePoolStatsChanged();
+}
+
+void YoloCameraController::updateHandoffStats(quint64 processed, quint64 dropped, quint64 stale, double rateLimit)
+{
+    if (std::abs(rateLimit - m_captureRateLimit) > 0.5) {
+        UiLogger::ctrl(rateLimit > 0.0 ? "YoloCameraController: Capture rate limited to " + QString::number(rateLimit, 'f', 1) + " FPS"
+                                       : QString("YoloCameraController: Capture rate limit lifted"));
+    }
+    m_framesProcessed = processed;
+    m_framesDropped = dropped;
+    m_framesStale = stale;
+    m_captureRateLimit = rateLimit;
+    emit handoffStatsChanged();
+}
+
 void YoloCameraController::handleResolutionChanged(QSize size)
 {
     if (m_currentResolution != size) {
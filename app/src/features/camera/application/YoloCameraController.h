@@ -16,6 +16,14 @@ class YoloCameraController : public QObject {
     Q_PROPERTY(double cameraFps READ cameraFps NOTIFY cameraFpsChanged)
     Q_PROPERTY(QVariantList supportedResolutions READ supportedResolutions NOTIFY supportedResolutionsChanged)
     Q_PROPERTY(QSize currentResolution READ currentResolution WRITE setCurrentResolution NOTIFY currentResolutionChanged)
+    Q_PROPERTY(int framePoolInUse READ framePoolInUse NOTIFY framePoolStatsChanged)
+    Q_PROPERTY(int framePoolSize READ framePoolSize NOTIFY framePoolStatsChanged)
+    Q_PROPERTY(int framePoolPeak READ framePoolPeak NOTIFY framePoolStatsChanged)
+    Q_PROPERTY(quint64 framePoolStarved READ framePoolStarved NOTIFY framePoolStatsChanged)
+    Q_PROPERTY(quint64 framesProcessed READ framesProcessed NOTIFY handoffStatsChanged)
+    Q_PROPERTY(quint64 framesDropped READ framesDropped NOTIFY handoffStatsChanged)
+    Q_PROPERTY(quint64 framesStale READ framesStale NOTIFY handoffStatsChanged)
+    Q_PROPERTY(double captureRateLimit READ captureRateLimit NOTIFY handoffStatsChanged)
 
 public:
     explicit YoloCameraController(CaptureWorker *worker, QObject *parent = nullptr);
@@ -26,10 +34,20 @@ public:
     double cameraFps() const { return m_cameraFps; }
     QVariantList supportedResolutions() const { return m_supportedResolutions; }
     QSize currentResolution() const { return m_currentResolution; }
+    int framePoolInUse() const { return m_framePoolInUse; }
+    int framePoolSize() const { return m_framePoolSize; }
+    int framePoolPeak() const { return m_framePoolPeak; }
+    quint64 framePoolStarved() const { return m_framePoolStarved; }
+    quint64 framesProcessed() const { return m_framesProcessed; }
+    quint64 framesDropped() const { return m_framesDropped; }
+    quint64 framesStale() const { return m_framesStale; }
+    double captureRateLimit() const { return m_captureRateLimit; }
 
 public slots:
     void setCurrentResolution(const QSize& size);
     void updateFps(double fps);
+    void updateFramePoolStats(int inUse, int capacity, int peakInUse, quint64 starved);
+    void updateHandoffStats(quint64 processed, quint64 dropped, quint64 stale, double rateLimit);
     void handleResolutionChanged(QSize size);
     void activate();
 
@@ -38,6 +56,8 @@ signals:
     void cameraFpsChanged();
     void supportedResolutionsChanged();
     void currentResolutionChanged();
+    void framePoolStatsChanged();
+    void handoffStatsChanged();
     
     void startCapture(QVideoSink* sink);
     void stopCapture();
@@ -49,6 +69,14 @@ private:
     double m_cameraFps = 0.0;
     QVariantList m_supportedResolutions;
     QSize m_currentResolution = QSize(640, 480);
+    int m_framePoolInUse = 0;
+    int m_framePoolSize = 0;
+    int m_framePoolPeak = 0;
+    quint64 m_framePoolStarved = 0;
+    quint64 m_framesProcessed = 0;
+    quint64 m_framesDropped = 0;
+    quint64 m_framesStale = 0;
+    double m_captureRateLimit = 0.0;
     std::unique_ptr<OpenCVCameraSource> m_source;
 
     void refreshResolutions();
@@ -11,6 +11,8 @@ public:
     virtual bool open(const SourceConfig& config) = 0;
     virtual void close() = 0;
     virtual bool readFrame(cv::Mat& outFrame) = 0;
+    // Advances one frame without decoding it; false if the source cannot
+    virtual bool skipFrame() { return false; }
     virtual QSize currentResolution() const = 0;
     virtual int64_t frameCount() const { return -1; }
     virtual int64_t currentFrameIndex() const { return -1; }
@@ -16,4 +16,7 @@ struct SourceConfig {
     QSize           resolution = QSize(640, 480);
     double          fps        = 30.0;
     bool            loop       = true;     // replay video when EOF reached
+    // false for offline processing: files are read as fast as they decode and a
+    // video ends at EOF instead of looping or holding its last frame
+    bool            realtime   = true;
 };
@@ -45,6 +45,12 @@ bool OpenCVCameraSource::readFrame(cv::Mat& outFrame) {
     return m_capture.read(outFrame);
 }
 
+bool OpenCVCameraSource::skipFrame() {
+    // grab() dequeues the buffer from the driver but leaves it undecoded
+    if (!m_capture.isOpened()) return false;
+    return m_capture.grab();
+}
+
 QSize OpenCVCameraSource::currentResolution() const {
     return m_currentResolution;
 }
@@ -11,6 +11,7 @@ public:
     bool open(const SourceConfig& config) override;
     void close() override;
     bool readFrame(cv::Mat& outFrame) override;
+    bool skipFrame() override;
     QSize currentResolution() const override;
 
 private:
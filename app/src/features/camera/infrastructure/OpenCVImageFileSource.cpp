@@ -17,6 +17,7 @@ bool OpenCVImageFileSource::open(const SourceConfig& config) {
     }
     
     m_resolution = QSize(m_image.cols, m_image.rows);
+    m_realtime = config.realtime;
     qDebug() << "[OpenCVImageFileSource]: Loaded image" << config.filePath << "at" << m_resolution;
     
     return true;
@@ -31,7 +32,7 @@ bool OpenCVImageFileSource::readFrame(cv::Mat& outFrame) {
     if (m_image.empty()) return false;
     
     // Simulate ~30fps to avoid 100% CPU usage for static images
-    QThread::msleep(33);
+    if (m_realtime) QThread::msleep(33);
     
     m_image.copyTo(outFrame);
     return true;
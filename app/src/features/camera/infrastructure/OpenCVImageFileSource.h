@@ -16,4 +16,5 @@ public:
 private:
     cv::Mat m_image;
     QSize m_resolution;
+    bool m_realtime = true;
 };
@@ -11,6 +11,7 @@ bool OpenCVVideoFileSource::open(const SourceConfig& config) {
     
     m_filePath = config.filePath;
     m_loop = config.loop;
+    m_realtime = config.realtime;
 
     if (m_filePath.isEmpty()) {
         qDebug() << "[OpenCVVideoFileSource]: Error - Empty file path.";
@@ -49,23 +50,26 @@ bool OpenCVVideoFileSource::readFrame(cv::Mat& outFrame) {
     if (!m_capture.isOpened()) return false;
 
     if (!m_capture.read(outFrame) || outFrame.empty()) {
+        if (!m_realtime) return false;
         if (m_loop) {
             m_capture.set(cv::CAP_PROP_POS_FRAMES, 0);
             if (m_capture.read(outFrame)) {
-                m_lastFrame = outFrame.clone();
+                m_lastFrame = outFrame;
                 return true;
             }
         } else {
-            // Pausing on last frame: if we have a last frame, use it
+            // Pausing on last frame: if we have a last frame, use it. Copied, since
+            // outFrame is a pooled buffer that will be decoded into again.
             if (!m_lastFrame.empty()) {
-                outFrame = m_lastFrame.clone();
+                m_lastFrame.copyTo(outFrame);
                 return true;
             }
         }
         return false;
     }
 
-    m_lastFrame = outFrame.clone();
+    // Shallow reference: only read back at EOF, when nothing overwrites it
+    m_lastFrame = outFrame;
     return true;
 }
 
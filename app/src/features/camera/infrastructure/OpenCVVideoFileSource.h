@@ -12,7 +12,7 @@ public:
     bool open(const SourceConfig& config) override;
     void close() override;
     bool readFrame(cv::Mat& outFrame) override;
-    bool skipFrame();
+    bool skipFrame() override;
     QSize currentResolution() const override;
 
     double nativeFps() const;
@@ -26,6 +26,7 @@ private:
     double m_nativeFps = 30.0;
     int64_t m_frameCount = -1;
     bool m_loop = true;
+    bool m_realtime = true;
     QString m_filePath;
     cv::Mat m_lastFrame;
 };
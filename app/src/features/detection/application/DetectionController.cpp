@@ -1,13 +1,20 @@
 #include "DetectionController.h"
 #include <QDebug>
+#include <QStringList>
+#include <QVariantMap>
 #include "../../shared/domain/UiLogger.h"
+#include "../../shared/domain/AppConfig.h"
+#include "../../../shared/infrastructure/TaskScheduler.h"
 
 DetectionController::DetectionController(InferenceWorker *worker, QObject *parent)
     : QObject(parent)
     , m_worker(worker)
     , m_model(new DetectionListModel(this))
 {
-    m_lastInferenceTime = std::chrono::steady_clock::now();
+    m_lastPublish = std::chrono::steady_clock::now();
+
+    connect(&m_latencyTimer, &QTimer::timeout, this, &DetectionController::publishLatency);
+    m_latencyTimer.start(AppConfig::LatencyPublishMs);
 }
 
 void DetectionController::setCurrentTask(YoloTask::TaskType task)
@@ -42,66 +49,182 @@ void DetectionController::setCurrentRuntime(YoloTask::RuntimeType runtime)
     }
 }
 
+void DetectionController::setPerformanceHint(YoloTask::PerformanceHint hint)
+{
+    if (m_performanceHint == hint) return;
+    UiLogger::ctrl(QString("DetectionController::setPerformanceHint → ") +
+                   (hint == YoloTask::PerformanceHint::Throughput ? "Throughput" : "Latency"));
+    m_performanceHint = hint;
+    emit performanceHintChanged();
+    if (m_currentTask != static_cast<YoloTask::TaskType>(-1) && 
+        m_currentRuntime != static_cast<YoloTask::RuntimeType>(-1)) {
+        resetFps();
+        emit requestModelChange(createCurrentConfig());
+    }
+}
+
+void DetectionController::cancelModelLoad()
+{
+    if (!m_modelLoading) return;
+    UiLogger::ctrl("DetectionController::cancelModelLoad");
+    emit requestCancelModelLoad();
+}
+
+void DetectionController::onModelLoaded(YoloTask::TaskType task, YoloTask::RuntimeType runtime)
+{
+    m_activeTask = task;
+    m_activeRuntime = runtime;
+    resetLatency();
+}
+
+void DetectionController::onModelLoadProgress(bool loading, double progress)
+{
+    m_modelLoading = loading;
+    m_modelLoadProgress = progress;
+    emit modelLoadingChanged();
+}
+
+void DetectionController::onModelLoadCancelled()
+{
+    // Point the selectors back at the model that is still running
+    if (m_currentTask != m_activeTask) {
+        m_currentTask = m_activeTask;
+        emit currentTaskChanged();
+    }
+    if (m_currentRuntime != m_activeRuntime) {
+        m_currentRuntime = m_activeRuntime;
+        emit currentRuntimeChanged();
+    }
+}
+
+void DetectionController::setSimdIsa(const QString& isa)
+{
+    if (m_simdIsa != isa) {
+        m_simdIsa = isa;
+        emit simdIsaChanged();
+    }
+}
+
 void DetectionController::updateDetections(const std::vector<DetectionResult>& results, 
                                           const std::vector<std::string>& classNames, 
                                           const InferenceTiming& timing, 
                                           const QSize& frameSize)
 {
     m_model->updateDetections(results, classNames, frameSize);
-    
-    m_preProcessTime = timing.preProcess;
-    m_inferenceTime = timing.inference;
-    m_postProcessTime = timing.postProcess;
-    emit timingChanged();
 
-    auto now = std::chrono::steady_clock::now();
-    double diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastInferenceTime).count();
-    
-    if (diff > 0) {
-        double currentFps = 1000.0 / diff;
-        if (m_inferenceFps == 0) m_inferenceFps = currentFps;
-        else m_inferenceFps = m_inferenceFps * 0.9 + currentFps * 0.1;
-        emit inferenceFpsChanged();
-    }
-    m_lastInferenceTime = now;
+    // Stage times were recorded by the worker; only the hops up to here are added
+    FrameTrace trace = timing.trace;
+    trace.mark(FrameTrace::Delivered);
+    m_worker->metrics().recordDelivered(trace);
 }
 
 InferenceConfig DetectionController::createCurrentConfig() const
+{
+    return configFor(m_currentTask, m_currentRuntime);
+}
+
+InferenceConfig DetectionController::configFor(YoloTask::TaskType task, YoloTask::RuntimeType runtime) const
 {
     InferenceConfig config;
-    config.taskType = m_currentTask;
-    config.runtimeType = m_currentRuntime;
-    
-    std::string taskDir;
-    std::string modelName;
-    
-    switch (m_currentTask) {
-        case YoloTask::TaskType::ObjectDetection:
-            taskDir = "detection";
-            modelName = "yolov8n";
-            break;
-        case YoloTask::TaskType::PoseEstimation:
-            taskDir = "pose";
-            modelName = "yolov8n-pose";
-            break;
-        case YoloTask::TaskType::ImageSegmentation:
-            taskDir = "segmentation";
-            modelName = "yolov8n-seg";
-            break;
-    }
-    
-    if (m_currentRuntime == YoloTask::RuntimeType::OpenVINO) {
-        config.modelPath = "assets/openvino/" + taskDir + "/" + modelName + ".xml";
-    } else {
-        config.modelPath = "assets/onnx/" + taskDir + "/" + modelName + ".onnx";
-    }
-    
+    config.taskType = task;
+    config.runtimeType = runtime;
+    config.performanceHint = m_performanceHint;
+    config.intraOpThreads = TaskScheduler::runtimeThreadBudget();
+    config.modelPath = defaultModelPath(task, runtime);
     return config;
 }
 
 void DetectionController::resetFps()
 {
     m_inferenceFps = 0.0;
-    m_lastInferenceTime = std::chrono::steady_clock::now();
     emit inferenceFpsChanged();
 }
+
+void DetectionController::resetLatency()
+{
+    // A new model starts with empty histograms so its tail is not mixed with the old one
+    m_worker->metrics().reset();
+    m_lastPublish = std::chrono::steady_clock::now();
+    m_preProcessTime = m_inferenceTime = m_postProcessTime = 0.0;
+    m_captureToDetectionPct.fill(0.0);
+    m_glassToGlassPct.fill(0.0);
+    m_latencyStats.clear();
+    m_hardwareCounters.clear();
+    emit timingChanged();
+    emit latencyChanged();
+}
+
+void DetectionController::onDetectionsPresented(const FrameTrace& trace)
+{
+    m_worker->metrics().recordPresented(trace);
+}
+
+void DetectionController::publishLatency()
+{
+    InferenceMetrics& metrics = m_worker->metrics();
+    metrics.tick();
+
+    const auto now = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(now - m_lastPublish).count();
+    m_lastPublish = now;
+    const uint64_t results = metrics.metric(InferenceMetrics::Total).lastIntervalCount();
+    const double fps = seconds > 0.0 ? results / seconds : 0.0;
+    if (fps != m_inferenceFps) {
+        m_inferenceFps = fps;
+        emit inferenceFpsChanged();
+    }
+    if (results == 0 && m_latencyStats.isEmpty()) return;
+
+    m_preProcessTime = metrics.metric(InferenceMetrics::PreProcess).window().p50;
+    m_inferenceTime = metrics.metric(InferenceMetrics::Inference).window().p50;
+    m_postProcessTime = metrics.metric(InferenceMetrics::PostProcess).window().p50;
+    emit timingChanged();
+
+    const RollingLatency::Summary captureToDetection = metrics.metric(InferenceMetrics::CaptureToDetection).window();
+    const RollingLatency::Summary glassToGlass = metrics.metric(InferenceMetrics::GlassToGlass).window();
+    m_captureToDetectionPct = {captureToDetection.p50, captureToDetection.p95, captureToDetection.p99};
+    m_glassToGlassPct = {glassToGlass.p50, glassToGlass.p95, glassToGlass.p99};
+
+    m_latencyStats.clear();
+    for (int i = 0; i < InferenceMetrics::MetricCount; ++i) {
+        const auto metric = static_cast<InferenceMetrics::Metric>(i);
+        const RollingLatency::Summary window = metrics.metric(metric).window();
+        if (window.count == 0) continue;
+        const RollingLatency::Summary total = metrics.metric(metric).total();
+
+        QVariantMap entry;
+        entry["name"] = QString::fromUtf8(InferenceMetrics::name(metric));
+        entry["count"] = static_cast<qulonglong>(window.count);
+        entry["p50"] = window.p50;
+        entry["p90"] = window.p90;
+        entry["p99"] = window.p99;
+        entry["max"] = window.max;
+        entry["totalP99"] = total.p99;
+        entry["totalMax"] = total.max;
+        m_latencyStats.append(entry);
+    }
+
+    const InferenceMetrics::StageCounters counters = metrics.takeCounters();
+    if (counters.frames > 0) {
+        static const char* stageNames[InferenceMetrics::StageCount] = {"Pre", "Infer", "Post"};
+        QStringList lines;
+        for (int i = 0; i < InferenceMetrics::StageCount; ++i) {
+            const HardwareCounters& stage = counters.stages[i];
+            lines << QString("%1 IPC %2  LLC %3k/f  br %4k/f")
+                .arg(stageNames[i], -5)
+                .arg(stage.ipc(), 4, 'f', 2)
+                .arg(stage.llcMisses / 1000.0 / counters.frames, 0, 'f', 1)
+                .arg(stage.branchMisses / 1000.0 / counters.frames, 0, 'f', 1);
+        }
+        m_hardwareCounters = lines.join("\n");
+    }
+    emit latencyChanged();
+}
+
+void DetectionController::onStageStatsUpdated(const QString& summary)
+{
+    if (m_stageStats != summary) {
+        m_stageStats = summary;
+        emit stageStatsChanged();
+    }
+}
@@ -6,8 +6,12 @@
 #include "../ui/DetectionListModel.h"
 #include "../domain/TaskType.h"
 #include "../domain/InferenceConfig.h"
+#include "../../../shared/domain/FrameTrace.h"
+#include <array>
 #include <chrono>
 #include <QSize>
+#include <QTimer>
+#include <QVariantList>
 
 class DetectionController : public QObject {
     Q_OBJECT
@@ -19,6 +23,19 @@ class DetectionController : public QObject {
     Q_PROPERTY(double inferenceTime READ inferenceTime NOTIFY timingChanged)
     Q_PROPERTY(double postProcessTime READ postProcessTime NOTIFY timingChanged)
     Q_PROPERTY(double inferenceFps READ inferenceFps NOTIFY inferenceFpsChanged)
+    Q_PROPERTY(QString simdIsa READ simdIsa NOTIFY simdIsaChanged)
+    Q_PROPERTY(bool modelLoading READ modelLoading NOTIFY modelLoadingChanged)
+    Q_PROPERTY(double modelLoadProgress READ modelLoadProgress NOTIFY modelLoadingChanged)
+    Q_PROPERTY(QString stageStats READ stageStats NOTIFY stageStatsChanged)
+    Q_PROPERTY(double captureToDetectionP50 READ captureToDetectionP50 NOTIFY latencyChanged)
+    Q_PROPERTY(double captureToDetectionP95 READ captureToDetectionP95 NOTIFY latencyChanged)
+    Q_PROPERTY(double captureToDetectionP99 READ captureToDetectionP99 NOTIFY latencyChanged)
+    Q_PROPERTY(double glassToGlassP50 READ glassToGlassP50 NOTIFY latencyChanged)
+    Q_PROPERTY(double glassToGlassP95 READ glassToGlassP95 NOTIFY latencyChanged)
+    Q_PROPERTY(double glassToGlassP99 READ glassToGlassP99 NOTIFY latencyChanged)
+    Q_PROPERTY(QVariantList latencyStats READ latencyStats NOTIFY latencyChanged)
+    Q_PROPERTY(QString hardwareCounters READ hardwareCounters NOTIFY latencyChanged)
+    Q_PROPERTY(YoloTask::PerformanceHint performanceHint READ performanceHint WRITE setPerformanceHint NOTIFY performanceHintChanged)
 
 public:
     explicit DetectionController(InferenceWorker *worker, QObject *parent = nullptr);
@@ -26,19 +43,48 @@ public:
     QObject* detections() const { return m_model; }
     YoloTask::TaskType currentTask() const { return m_currentTask; }
     YoloTask::RuntimeType currentRuntime() const { return m_currentRuntime; }
+    YoloTask::PerformanceHint performanceHint() const { return m_performanceHint; }
+    bool modelLoading() const { return m_modelLoading; }
+    double modelLoadProgress() const { return m_modelLoadProgress; }
+
+    // Abandons a background model build; the active model keeps running
+    Q_INVOKABLE void cancelModelLoad();
     
     double preProcessTime() const { return m_preProcessTime; }
     double inferenceTime() const { return m_inferenceTime; }
     double postProcessTime() const { return m_postProcessTime; }
     double inferenceFps() const { return m_inferenceFps; }
+    QString simdIsa() const { return m_simdIsa; }
+    QString stageStats() const { return m_stageStats; }
+    double captureToDetectionP50() const { return m_captureToDetectionPct[0]; }
+    double captureToDetectionP95() const { return m_captureToDetectionPct[1]; }
+    double captureToDetectionP99() const { return m_captureToDetectionPct[2]; }
+    double glassToGlassP50() const { return m_glassToGlassPct[0]; }
+    double glassToGlassP95() const { return m_glassToGlassPct[1]; }
+    double glassToGlassP99() const { return m_glassToGlassPct[2]; }
+    // One map per metric: name, count and p50/p90/p99/max over the rolling
+    // window, plus p99/max since the model was loaded (ms)
+    QVariantList latencyStats() const { return m_latencyStats; }
+    // IPC and misses per frame for each stage, empty without hardware counters
+    QString hardwareCounters() const { return m_hardwareCounters; }
+    void setSimdIsa(const QString& isa);
+
+    // Config the controller would request for a task/runtime under the current settings
+    InferenceConfig configFor(YoloTask::TaskType task, YoloTask::RuntimeType runtime) const;
 
 public slots:
     void setCurrentTask(YoloTask::TaskType task);
     void setCurrentRuntime(YoloTask::RuntimeType runtime);
+    void setPerformanceHint(YoloTask::PerformanceHint hint);
     void updateDetections(const std::vector<DetectionResult>& results, 
                           const std::vector<std::string>& classNames, 
                           const InferenceTiming& timing, 
                           const QSize& frameSize);
+    void onModelLoaded(YoloTask::TaskType task, YoloTask::RuntimeType runtime);
+    void onModelLoadProgress(bool loading, double progress);
+    void onModelLoadCancelled();
+    void onStageStatsUpdated(const QString& summary);
+    void onDetectionsPresented(const FrameTrace& trace);
 
 signals:
     void detectionsChanged();
@@ -46,9 +92,15 @@ signals:
     void currentRuntimeChanged();
     void timingChanged();
     void inferenceFpsChanged();
+    void simdIsaChanged();
+    void performanceHintChanged();
+    void modelLoadingChanged();
+    void stageStatsChanged();
+    void latencyChanged();
     
     // Internal signal to trigger worker change
     void requestModelChange(const InferenceConfig& config);
+    void requestCancelModelLoad();
 
 private:
     InferenceWorker *m_worker;
@@ -56,14 +108,33 @@ private:
     
     YoloTask::TaskType m_currentTask = static_cast<YoloTask::TaskType>(-1);
     YoloTask::RuntimeType m_currentRuntime = static_cast<YoloTask::RuntimeType>(-1);
+    YoloTask::PerformanceHint m_performanceHint = YoloTask::PerformanceHint::Latency;
+
+    // Model actually serving frames (the current* pair may point at one still loading)
+    YoloTask::TaskType m_activeTask = static_cast<YoloTask::TaskType>(-1);
+    YoloTask::RuntimeType m_activeRuntime = static_cast<YoloTask::RuntimeType>(-1);
+    bool m_modelLoading = false;
+    double m_modelLoadProgress = 0.0;
     
+    // Stage p50s and result rate, from the histograms at each publish
     double m_preProcessTime = 0.0;
     double m_inferenceTime = 0.0;
     double m_postProcessTime = 0.0;
     double m_inferenceFps = 0.0;
-    
-    std::chrono::time_point<std::chrono::steady_clock> m_lastInferenceTime;
+    QString m_simdIsa;
+    QString m_stageStats;
+
+
+    // Latency histograms (InferenceMetrics) published every AppConfig::LatencyPublishMs
+    std::array<double, 3> m_captureToDetectionPct{};
+    std::array<double, 3> m_glassToGlassPct{};
+    QVariantList m_latencyStats;
+    QString m_hardwareCounters;
+    QTimer m_latencyTimer;
+    std::chrono::steady_clock::time_point m_lastPublish;
     
     InferenceConfig createCurrentConfig() const;
     void resetFps();
+    void resetLatency();
+    void publishLatency();
 };
@@ -0,0 +1,86 @@
+#include "InferenceMetrics.h"
+#include "../../../shared/domain/AppConfig.h"
+#include <cstdlib>
+
+const char* InferenceMetrics::name(Metric metric)
+{
+    static const char* names[MetricCount] = {
+        "pre", "infer", "post", "total", "queue", "dispatch", "present",
+        "capture→det", "glass→glass", "interval", "jitter"
+    };
+    return names[metric];
+}
+
+InferenceMetrics::InferenceMetrics()
+{
+    for (RollingLatency& metric : m_metrics) metric.setIntervals(static_cast<size_t>(AppConfig::LatencyWindowSeconds));
+}
+
+void InferenceMetrics::recordResult(const InferenceTiming& timing)
+{
+    m_metrics[PreProcess].record(timing.preProcess);
+    m_metrics[Inference].record(timing.inference);
+    m_metrics[PostProcess].record(timing.postProcess);
+    m_metrics[Total].record(timing.total);
+    m_metrics[Queue].record(timing.trace.msBetween(FrameTrace::Captured, FrameTrace::Dequeued));
+
+    if (timing.preCounters.valid && timing.inferCounters.valid && timing.postCounters.valid) {
+        const HardwareCounters* stages[StageCount] = {&timing.preCounters, &timing.inferCounters, &timing.postCounters};
+        for (int i = 0; i < StageCount; ++i) {
+            m_counters[i].cycles.fetch_add(stages[i]->cycles, std::memory_order_relaxed);
+            m_counters[i].instructions.fetch_add(stages[i]->instructions, std::memory_order_relaxed);
+            m_counters[i].llcMisses.fetch_add(stages[i]->llcMisses, std::memory_order_relaxed);
+            m_counters[i].branchMisses.fetch_add(stages[i]->branchMisses, std::memory_order_relaxed);
+        }
+        m_counterFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const int64_t now = FrameTrace::now();
+    const int64_t previous = m_lastResultNs.exchange(now, std::memory_order_relaxed);
+    if (previous == 0) return;
+
+    const int64_t interval = now - previous;
+    m_metrics[Interval].record(interval / 1e6);
+    const int64_t previousInterval = m_lastIntervalNs.exchange(interval, std::memory_order_relaxed);
+    if (previousInterval >= 0) m_metrics[Jitter].record(std::llabs(interval - previousInterval) / 1e6);
+}
+
+void InferenceMetrics::recordDelivered(const FrameTrace& trace)
+{
+    m_metrics[Dispatch].record(trace.msBetween(FrameTrace::Emitted, FrameTrace::Delivered));
+    m_metrics[CaptureToDetection].record(trace.msBetween(FrameTrace::Captured, FrameTrace::Delivered));
+}
+
+void InferenceMetrics::recordPresented(const FrameTrace& trace)
+{
+    m_metrics[Present].record(trace.msBetween(FrameTrace::Emitted, FrameTrace::Presented));
+    m_metrics[GlassToGlass].record(trace.msBetween(FrameTrace::Captured, FrameTrace::Presented));
+}
+
+void InferenceMetrics::tick()
+{
+    for (RollingLatency& metric : m_metrics) metric.tick();
+}
+
+InferenceMetrics::StageCounters InferenceMetrics::takeCounters()
+{
+    StageCounters taken;
+    taken.frames = m_counterFrames.exchange(0, std::memory_order_relaxed);
+    for (int i = 0; i < StageCount; ++i) {
+        HardwareCounters& stage = taken.stages[i];
+        stage.cycles = m_counters[i].cycles.exchange(0, std::memory_order_relaxed);
+        stage.instructions = m_counters[i].instructions.exchange(0, std::memory_order_relaxed);
+        stage.llcMisses = m_counters[i].llcMisses.exchange(0, std::memory_order_relaxed);
+        stage.branchMisses = m_counters[i].branchMisses.exchange(0, std::memory_order_relaxed);
+        stage.valid = taken.frames > 0;
+    }
+    return taken;
+}
+
+void InferenceMetrics::reset()
+{
+    m_lastResultNs.store(0, std::memory_order_relaxed);
+    m_lastIntervalNs.store(-1, std::memory_order_relaxed);
+    for (RollingLatency& metric : m_metrics) metric.reset();
+    takeCounters();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "../domain/InferenceTiming.h"
+#include "../../../shared/infrastructure/LatencyHistogram.h"
+
+/**
+ * @brief Latency histograms for every inference stage, the frame's hops to the
+ * screen, and the spacing of results.
+ *
+ * The thread emitting results (inference or post stage) calls recordResult(),
+ * the GUI thread the delivered/presented hooks; recording is lock-free. tick(),
+ * reset() and the readouts belong to the GUI thread.
+ */
+class InferenceMetrics {
+public:
+    enum Metric {
+        PreProcess,
+        Inference,
+        PostProcess,
+        Total,
+        Queue,              // captured -> taken by inference
+        Dispatch,           // emitted -> received by DetectionController
+        Present,            // emitted -> first display frame showing it
+        CaptureToDetection,
+        GlassToGlass,
+        Interval,           // time between consecutive results
+        Jitter,             // change of that time from one result to the next
+        MetricCount
+    };
+
+    static const char* name(Metric metric);
+
+    enum Stage { PreStage, InferStage, PostStage, StageCount };
+
+    // Hardware counter totals per stage since the previous takeCounters()
+    struct StageCounters {
+        std::array<HardwareCounters, StageCount> stages;
+        uint64_t frames = 0;
+    };
+
+    // Windows span AppConfig::LatencyWindowSeconds ticks
+    InferenceMetrics();
+
+    void recordResult(const InferenceTiming& timing);
+    void recordDelivered(const FrameTrace& trace);
+    void recordPresented(const FrameTrace& trace);
+
+    void tick();
+    void reset();
+
+    const RollingLatency& metric(Metric metric) const { return m_metrics[metric]; }
+    StageCounters takeCounters();
+
+private:
+    struct CounterSums {
+        std::atomic<uint64_t> cycles{0};
+        std::atomic<uint64_t> instructions{0};
+        std::atomic<uint64_t> llcMisses{0};
+        std::atomic<uint64_t> branchMisses{0};
+    };
+
+    std::array<RollingLatency, MetricCount> m_metrics;
+    std::array<CounterSums, StageCount> m_counters;
+    std::atomic<uint64_t> m_counterFrames{0};
+    std::atomic<int64_t> m_lastResultNs{0};
+    std::atomic<int64_t> m_lastIntervalNs{-1};
+};
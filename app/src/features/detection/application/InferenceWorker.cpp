@@ -1,71 +1,287 @@
 #include "InferenceWorker.h"
 #include <QDebug>
 #include "../../shared/domain/UiLogger.h"
-#include <fstream>
-#include <thread>
+#include "../../shared/domain/AppConfig.h"
+#include "../../../shared/infrastructure/ThreadNames.h"
+#include "../../../shared/infrastructure/Tracer.h"
 #include <QSize>
+#include <QCoreApplication>
+#include <QAbstractEventDispatcher>
+#include <QThread>
+#include <QTimer>
+#include <chrono>
 
-InferenceWorker::InferenceWorker(IDetectionModel *model, QObject *parent)
+InferenceWorker::InferenceWorker(ModelRegistry *registry, QObject *parent)
     : QObject(parent)
-    , m_model(model)
+    , m_registry(registry)
 {
 }
 
 InferenceWorker::~InferenceWorker()
 {
     stopInference();
+    m_stages.reset();
+    releaseModel();
 }
 
 void InferenceWorker::startInference(const InferenceConfig& config)
 {
-    if (!m_model) return;
+    if (!m_registry) return;
 
-    m_running = false; 
-    while (m_isProcessing.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    // A newer request supersedes any load still in progress
+    if (m_loadJob != 0) {
+        m_registry->cancel(m_loadJob);
+        m_loadJob = 0;
     }
+    const quint64 ticket = ++m_loadTicket;
 
-    auto t0 = std::chrono::steady_clock::now();
     UiLogger::ctrl("InferenceWorker: Requesting session → \"" + QString::fromStdString(config.modelPath) + "\"");
-    
-    const char* status = m_model->createSession(config);
 
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now() - t0).count();
+    // A live session from the registry is a pointer swap at this frame boundary
+    // (looked up and touched in one step, so eviction cannot slip in between)
+    if (std::shared_ptr<IDetectionModel> model = m_registry->tryAcquire(config)) {
+        onModelReady(ticket, config, model, nullptr, 0);
+        return;
+    }
 
-    if (status != nullptr) {
+    // Otherwise build it on the registry's loader thread; the current session
+    // keeps serving frames until the new one is swapped in
+    emit modelLoadProgress(true, 0.0);
+    auto t0 = std::chrono::steady_clock::now();
+    m_loadJob = m_registry->loadAsync(config,
+        [this, ticket](float progress) {
+            QMetaObject::invokeMethod(this, [this, ticket, progress]() {
+                if (ticket == m_loadTicket) emit modelLoadProgress(true, progress);
+            }, Qt::QueuedConnection);
+        },
+        [this, ticket, config, t0](std::shared_ptr<IDetectionModel> model, const char* status) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+            QMetaObject::invokeMethod(this, [this, ticket, config, model, status, elapsed]() {
+                onModelReady(ticket, config, model, status, elapsed);
+            }, Qt::QueuedConnection);
+        });
+}
+
+void InferenceWorker::cancelModelLoad()
+{
+    if (m_loadJob == 0) return;
+    m_registry->cancel(m_loadJob);
+    m_loadJob = 0;
+    ++m_loadTicket;
+    UiLogger::ctrl("InferenceWorker: Model load cancelled, keeping current session");
+    emit modelLoadProgress(false, 0.0);
+    emit modelLoadCancelled();
+}
+
+void InferenceWorker::onModelReady(quint64 ticket, const InferenceConfig& config,
+                                   std::shared_ptr<IDetectionModel> model, const char* status,
+                                   qint64 elapsedMs)
+{
+    if (ticket != m_loadTicket) return; // superseded or cancelled
+    m_loadJob = 0;
+    emit modelLoadProgress(false, model ? 1.0 : 0.0);
+
+    if (!model) {
         UiLogger::ctrl("InferenceWorker: Session FAILED → " + QString(status));
         emit errorOccurred("Initialization Error", QString("[YoloPipeline]: %1").arg(status));
         return;
     }
 
+    // Swap between frames: finish the old session's requests, then serve from the new one
+    if (m_stages) m_stages->stop();
+    releaseModel();
+    m_model = std::move(model);
+
+    // Sessions are cached without their post-processing settings; apply this request's
+    if (const char* error = m_model->configurePostProcessing(config)) {
+        m_model.reset();
+        UiLogger::ctrl("InferenceWorker: Session FAILED → " + QString(error));
+        emit errorOccurred("Initialization Error", QString(error));
+        return;
+    }
+
+    size_t slots = static_cast<size_t>(m_model->maxInFlight());
+    m_slotSequence.assign(slots, 0);
+    m_slotFrameSize.assign(slots, QSize());
+    m_slotTrace.assign(slots, FrameTrace());
+    m_slotPending.assign(slots, false);
+    m_nextSequence = 0;
+    m_lastEmittedSequence = 0;
+
     m_running = true;
-    UiLogger::ctrl("InferenceWorker: Session created → OK (" + QString::number(elapsed) + " ms)");
+    // Stages only overlap with a free slot to prepare into while another runs
+    if (AppConfig::StagedInference && m_frameRing && slots >= 2) startStages();
+    UiLogger::ctrl("InferenceWorker: Session ready → OK (" + QString::number(elapsedMs) + " ms, "
+                   + QString::number(slots) + " in flight" + (m_stages && m_stages->isRunning() ? ", staged" : "") + ")");
     emit modelLoaded(config.taskType, config.runtimeType);
 }
 
 void InferenceWorker::stopInference()
 {
     m_running = false;
+    m_loopRunning = false;
+    if (m_frameRing) m_frameRing->wake();
+    if (QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance(thread())) {
+        dispatcher->wakeUp();
+    }
+}
+
+void InferenceWorker::startStages()
+{
+    if (!m_stages) {
+        StagedPipeline::Options options;
+        options.queueDepth = static_cast<size_t>(AppConfig::StageQueueDepth);
+        options.dropPolicy = static_cast<QueueDropPolicy>(AppConfig::StageQueueDropPolicy);
+
+        // Called on the post-processing thread; emitting queues to the receivers
+        m_stages = std::make_unique<StagedPipeline>(m_frameRing, options,
+            [this](std::vector<DetectionResult>& results, const InferenceTiming& timing, const QSize& frameSize) {
+                if (!m_running) return;
+                m_metrics.recordResult(timing);
+                emit detectionsReady(results, m_model->classNames(), timing, frameSize);
+                emit latestDetectionsReady(std::make_shared<std::vector<DetectionResult>>(std::move(results)), frameSize, timing.trace);
+            },
+            [](const char* error) {
+                UiLogger::ctrl("InferenceWorker: Inference FAILED → " + QString(error));
+            });
+    }
+    m_stages->start(m_model);
+}
+
+void InferenceWorker::publishStageStats()
+{
+    if (!m_stages || !m_stages->isRunning()) return;
+
+    const StagedPipeline::Stats stats = m_stages->takeStats();
+    auto line = [](const char* name, const StagedPipeline::StageStats& s) {
+        QString text = QString("%1 %2 ms  wait %3 ms  q %4/%5")
+            .arg(name, -5)
+            .arg(s.avgBusyMs, 5, 'f', 1)
+            .arg(s.avgWaitMs, 5, 'f', 1)
+            .arg(s.queueDepth)
+            .arg(s.queueCapacity);
+        if (s.dropped > 0) text += QString("  drop %1").arg(s.dropped);
+        return text;
+    };
+    emit stageStatsUpdated(line("Pre", stats.pre) + "\n" + line("Infer", stats.infer) + "\n" + line("Post", stats.post));
 }
 
-void InferenceWorker::processFrame(std::shared_ptr<cv::Mat> frame)
+void InferenceWorker::run()
 {
-    if (!m_running || !m_model || !frame) return;
+    if (m_loopRunning.exchange(true)) return;
+    ThreadNames::setCurrent("inference");
 
-    bool expected = false;
-    if (!m_isProcessing.compare_exchange_strong(expected, true)) {
-        return; 
+    QTimer statsTimer;
+    connect(&statsTimer, &QTimer::timeout, this, &InferenceWorker::publishStageStats);
+    statsTimer.start(1000);
+
+    while (m_loopRunning) {
+        QCoreApplication::processEvents();
+        if (!m_loopRunning || !m_frameRing) break;
+
+        if (m_stages && m_stages->isRunning()) {
+            // The stage threads consume the ring; just service model changes
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+            continue;
+        }
+
+        if (canAcceptFrame()) {
+            int slot = m_frameRing->tryAcquire();
+            if (slot >= 0) {
+                // Preprocessing reads the shared frame into the request's input, so the
+                // slot (and its pooled buffer) is released right after
+                const FrameRef& frame = m_frameRing->frame(slot);
+                FrameTrace trace = m_frameRing->trace(slot);
+                trace.mark(FrameTrace::Dequeued);
+                if (frame) processFrame(*frame, trace);
+                m_frameRing->release(slot);
+                continue;
+            }
+        }
+        // Woken by a new frame, a completion or stop
+        m_frameRing->wait(std::chrono::milliseconds(5));
+    }
+
+    // Drain on the owning thread; stopInference may be called from any thread
+    if (m_stages) m_stages->stop();
+    releaseModel();
+}
+
+bool InferenceWorker::canAcceptFrame() const
+{
+    return m_running && m_model && m_inFlight < m_model->maxInFlight();
+}
+
+void InferenceWorker::releaseModel()
+{
+    if (!m_model) return;
+
+    // Let in-flight requests finish and free their slots, since the session may
+    // be handed out again by the registry. Their queued completions are dropped.
+    m_model->waitForPending();
+    for (size_t slot = 0; slot < m_slotPending.size(); ++slot) {
+        if (!m_slotPending[slot]) continue;
+        std::vector<DetectionResult> discarded;
+        InferenceTiming timing;
+        m_model->completeInference(static_cast<int>(slot), discarded, timing);
+        m_slotPending[slot] = false;
     }
+    ++m_generation;
+    m_inFlight = 0;
+    m_model.reset();
+}
 
+void InferenceWorker::processFrame(const cv::Mat& frame, const FrameTrace& trace)
+{
+    if (!canAcceptFrame() || frame.empty()) return;
+
+    // Preprocess now and start inference; post-processing runs when the
+    // runtime reports completion, so the next frame overlaps this one's inference
+    const quint64 generation = m_generation;
+    int slot = m_model->submitInference(frame, [this, generation](int done) {
+        QMetaObject::invokeMethod(this, [this, done, generation]() {
+            finishFrame(done, generation);
+        }, Qt::QueuedConnection);
+        if (m_frameRing) m_frameRing->wake();
+    });
+    if (slot < 0) return;
+
+    m_slotFrameSize[slot] = QSize(frame.cols, frame.rows);
+    m_slotTrace[slot] = trace;
+    m_slotTrace[slot].mark(FrameTrace::Prepared);
+    m_slotPending[slot] = true;
+    m_slotSequence[slot] = ++m_nextSequence;
+    ++m_inFlight;
+}
+
+void InferenceWorker::finishFrame(int slot, quint64 generation)
+{
+    if (generation != m_generation) return;
+
+    m_slotTrace[slot].mark(FrameTrace::Inferred);
     std::vector<DetectionResult> results;
     InferenceTiming timing;
-    
-    QSize frameSize(frame->cols, frame->rows);
-    m_model->runInference(*frame, results, timing);
+    const char* status = m_model->completeInference(slot, results, timing);
+    m_slotPending[slot] = false;
+    timing.trace = m_slotTrace[slot];
+    timing.trace.mark(FrameTrace::PostProcessed);
 
-    emit detectionsReady(results, m_model->classNames(), timing, frameSize);
-    emit latestDetectionsReady(std::make_shared<std::vector<DetectionResult>>(results), frameSize);
+    --m_inFlight;
 
-    m_isProcessing = false;
+    if (status != nullptr) {
+        UiLogger::ctrl("InferenceWorker: Inference FAILED → " + QString(status));
+        return;
+    }
+    if (!m_running) return;
+
+    // With several streams frames can complete out of order; never replace newer detections
+    if (m_slotSequence[slot] < m_lastEmittedSequence) return;
+    m_lastEmittedSequence = m_slotSequence[slot];
+
+    const QSize frameSize = m_slotFrameSize[slot];
+    timing.trace.mark(FrameTrace::Emitted);
+    m_metrics.recordResult(timing);
+    emit detectionsReady(results, m_model->classNames(), timing, frameSize);
+    emit latestDetectionsReady(std::make_shared<std::vector<DetectionResult>>(results), frameSize, timing.trace);
 }
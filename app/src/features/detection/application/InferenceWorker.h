@@ -3,18 +3,29 @@
 #include <QObject>
 #include <memory>
 #include <atomic>
+#include <vector>
+#include <QSize>
 #include <opencv2/opencv.hpp>
 #include "../domain/IDetectionModel.h"
+#include "ModelRegistry.h"
+#include "StagedPipeline.h"
+#include "InferenceMetrics.h"
 #include "../domain/DetectionResult.h"
 #include "../domain/InferenceConfig.h"
+#include "../../../shared/infrastructure/FrameRing.h"
 
 class InferenceWorker : public QObject {
     Q_OBJECT
 
 public:
-    explicit InferenceWorker(IDetectionModel *model, QObject *parent = nullptr);
+    explicit InferenceWorker(ModelRegistry *registry, QObject *parent = nullptr);
     ~InferenceWorker() override;
 
+    void setFrameRing(FrameRing* ring) { m_frameRing = ring; }
+
+    // Recorded by whichever thread emits results; read and ticked by the GUI thread
+    InferenceMetrics& metrics() { return m_metrics; }
+
 signals:
     void detectionsReady(const std::vector<DetectionResult>& results, 
                          const std::vector<std::string>& classNames, 
@@ -22,20 +33,61 @@ signals:
                          const QSize& frameSize);
     
     void latestDetectionsReady(std::shared_ptr<std::vector<DetectionResult>> results, 
-                               const QSize& frameSize);
+                               const QSize& frameSize,
+                               const FrameTrace& trace);
     
     void modelLoaded(YoloTask::TaskType taskType, YoloTask::RuntimeType runtimeType);
+    void modelLoadProgress(bool loading, double progress);
+    void modelLoadCancelled();
     void errorOccurred(const QString& title, const QString& message);
+    // Per-stage timing and queue occupancy, once a second while staged
+    void stageStatsUpdated(const QString& summary);
 
 public slots:
     void startInference(const InferenceConfig& config);
+    // Safe from any thread: only flags the loop and wakes it; run() drains the
+    // session's requests on its way out
     void stopInference();
-    void processFrame(std::shared_ptr<cv::Mat> frame);
-    
-    std::atomic<bool>* getProcessingFlag() { return &m_isProcessing; }
+    void cancelModelLoad();
+
+    // Inference thread main loop: takes the latest frame from the ring whenever a
+    // request slot is free, and services queued events (model changes, completions)
+    void run();
 
 private:
-    IDetectionModel *m_model;
+    void processFrame(const cv::Mat& frame, const FrameTrace& trace);
+    bool canAcceptFrame() const;
+    void startStages();
+    void publishStageStats();
+    void finishFrame(int slot, quint64 generation);
+    void releaseModel();
+    void onModelReady(quint64 ticket, const InferenceConfig& config,
+                      std::shared_ptr<IDetectionModel> model, const char* status,
+                      qint64 elapsedMs);
+
+    ModelRegistry *m_registry;
+    std::shared_ptr<IDetectionModel> m_model;
     std::atomic<bool> m_running{false};
-    std::atomic<bool> m_isProcessing{false};
+    std::atomic<bool> m_loopRunning{false};
+    FrameRing* m_frameRing = nullptr;
+    InferenceMetrics m_metrics;
+
+    // Staged mode (AppConfig::StagedInference): the stage threads take frames from
+    // the ring and emit results themselves; this thread only swaps models
+    std::unique_ptr<StagedPipeline> m_stages;
+
+    // Pipelining state, touched only on the inference thread
+    int m_inFlight = 0;
+    quint64 m_generation = 0;          // bumped per session; queued completions of older sessions are dropped
+    quint64 m_nextSequence = 0;
+    quint64 m_lastEmittedSequence = 0;
+    std::vector<quint64> m_slotSequence;
+    std::vector<QSize> m_slotFrameSize;
+    std::vector<FrameTrace> m_slotTrace;
+    std::vector<bool> m_slotPending;
+
+    // Background load in progress (registry job id, 0 = none); the ticket
+    // identifies the newest request so stale completions are ignored
+    uint64_t m_loadJob = 0;
+    quint64 m_loadTicket = 0;
 };
@@ -0,0 +1,229 @@
+#include "ModelRegistry.h"
+#include "../../shared/domain/UiLogger.h"
+#include "../../../shared/infrastructure/ThreadNames.h"
+#include <chrono>
+
+ModelRegistry::ModelRegistry(Factory factory, size_t budgetBytes)
+    : m_factory(std::move(factory))
+    , m_budgetBytes(budgetBytes)
+{
+}
+
+ModelRegistry::~ModelRegistry()
+{
+    shutdown();
+}
+
+void ModelRegistry::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopLoader = true;
+        for (auto& job : m_jobs) job->cancelled = true;
+        if (m_currentJob) m_currentJob->cancelled = true;
+    }
+    m_jobReady.notify_all();
+    if (m_loaderThread.joinable()) m_loaderThread.join();
+}
+
+std::string ModelRegistry::keyFor(const InferenceConfig& config)
+{
+    return std::to_string(static_cast<int>(config.taskType)) + "/"
+         + std::to_string(static_cast<int>(config.runtimeType)) + "/"
+         + std::to_string(config.imgSize.at(0)) + "x" + std::to_string(config.imgSize.at(1)) + "/"
+         + config.precision + "/"
+         + std::to_string(static_cast<int>(config.performanceHint));
+}
+
+std::shared_ptr<IDetectionModel> ModelRegistry::acquire(const InferenceConfig& config,
+                                                        const char** error,
+                                                        bool* hit,
+                                                        const IDetectionModel::LoadProgress& progress)
+{
+    const std::string key = keyFor(config);
+    if (error) *error = nullptr;
+    if (hit) *hit = false;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_buildDone.wait(lock, [&]() { return m_building.count(key) == 0; });
+
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            if (hit) *hit = true;
+            return it->second->model;
+        }
+        m_building.insert(key);
+    }
+
+    // Build outside the lock so other keys stay available
+    std::shared_ptr<IDetectionModel> model = m_factory();
+    const char* status = model->createSession(config, progress);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_building.erase(key);
+    m_buildDone.notify_all();
+
+    if (status != nullptr) {
+        if (error) *error = status;
+        return nullptr;
+    }
+    insertLocked(key, model);
+    return model;
+}
+
+uint64_t ModelRegistry::loadAsync(const InferenceConfig& config, ProgressCallback onProgress, DoneCallback onDone)
+{
+    auto job = std::make_shared<LoadJob>();
+    job->config = config;
+    job->onProgress = std::move(onProgress);
+    job->onDone = std::move(onDone);
+    return enqueue(job) ? job->id : 0;
+}
+
+void ModelRegistry::cancel(uint64_t jobId)
+{
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    for (auto& job : m_jobs) {
+        if (job->id == jobId) job->cancelled = true;
+    }
+    if (m_currentJob && m_currentJob->id == jobId) m_currentJob->cancelled = true;
+}
+
+void ModelRegistry::prewarm(const std::vector<InferenceConfig>& configs)
+{
+    for (const InferenceConfig& config : configs) {
+        auto job = std::make_shared<LoadJob>();
+        job->config = config;
+        job->background = true;
+        enqueue(job);
+    }
+}
+
+bool ModelRegistry::enqueue(std::shared_ptr<LoadJob> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if (m_stopLoader) return false;
+        job->id = ++m_nextJobId;
+        if (job->background) {
+            m_jobs.push_back(job);
+        } else {
+            // User requests go ahead of prewarm work; only the newest one matters
+            for (auto& queued : m_jobs) {
+                if (!queued->background) queued->cancelled = true;
+            }
+            m_jobs.push_front(job);
+        }
+        if (!m_loaderThread.joinable()) {
+            m_loaderThread = std::thread(&ModelRegistry::loaderLoop, this);
+        }
+    }
+    m_jobReady.notify_one();
+    return true;
+}
+
+void ModelRegistry::loaderLoop()
+{
+    ThreadNames::setCurrent("model-loader");
+    while (true) {
+        std::shared_ptr<LoadJob> job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            m_jobReady.wait(lock, [this]() { return m_stopLoader || !m_jobs.empty(); });
+            if (m_stopLoader) return;
+            job = m_jobs.front();
+            m_jobs.pop_front();
+            m_currentJob = job;
+        }
+
+        if (job->background && contains(job->config)) {
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            m_currentJob.reset();
+            continue;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        const char* status = kLoadCancelled;
+        std::shared_ptr<IDetectionModel> model;
+        if (!job->cancelled) {
+            model = acquire(job->config, &status, nullptr, [job](float progress) {
+                if (job->onProgress) job->onProgress(progress);
+                return !job->cancelled.load();
+            });
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        QString modelPath = QString::fromStdString(job->config.modelPath);
+        if (job->background) {
+            if (status != nullptr) {
+                UiLogger::ctrl("ModelRegistry: Prewarm FAILED → \"" + modelPath + "\" (" + QString(status) + ")");
+            } else {
+                UiLogger::ctrl("ModelRegistry: Prewarmed → \"" + modelPath + "\" (" + QString::number(elapsed) + " ms)");
+            }
+        } else if (status == kLoadCancelled) {
+            UiLogger::ctrl("ModelRegistry: Load cancelled → \"" + modelPath + "\"");
+        }
+
+        if (job->onDone) job->onDone(model, status);
+
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_currentJob.reset();
+    }
+}
+
+std::shared_ptr<IDetectionModel> ModelRegistry::tryAcquire(const InferenceConfig& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(keyFor(config));
+    if (it == m_index.end()) return nullptr;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->model;
+}
+
+bool ModelRegistry::contains(const InferenceConfig& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.count(keyFor(config)) > 0;
+}
+
+void ModelRegistry::setBudget(size_t budgetBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budgetBytes = budgetBytes;
+    evictLocked();
+}
+
+size_t ModelRegistry::usedBytes()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usedBytes;
+}
+
+void ModelRegistry::insertLocked(const std::string& key, std::shared_ptr<IDetectionModel> model)
+{
+    Entry entry;
+    entry.key = key;
+    entry.bytes = model->memoryFootprint();
+    entry.model = std::move(model);
+
+    m_usedBytes += entry.bytes;
+    m_lru.push_front(std::move(entry));
+    m_index[key] = m_lru.begin();
+    evictLocked();
+}
+
+void ModelRegistry::evictLocked()
+{
+    // Never evict the most recent entry, even if it alone exceeds the budget
+    while (m_usedBytes > m_budgetBytes && m_lru.size() > 1) {
+        Entry& victim = m_lru.back();
+        UiLogger::ctrl("ModelRegistry: Evicting " + QString::fromStdString(victim.key) + " ("
+                       + QString::number(victim.bytes / (1024 * 1024)) + " MB)");
+        m_usedBytes -= victim.bytes;
+        m_index.erase(victim.key);
+        m_lru.pop_back();
+    }
+}
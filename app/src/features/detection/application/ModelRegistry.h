@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <functional>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include "../domain/IDetectionModel.h"
+#include "../domain/InferenceConfig.h"
+
+/**
+ * @brief Keeps compiled detection sessions alive so task/runtime switches are a pointer swap.
+ *
+ * Sessions are keyed by (task, runtime, input size, precision, performance hint)
+ * only; whoever takes a session applies its own post-processing settings
+ * (IDetectionModel::configurePostProcessing). Sessions are evicted
+ * least-recently-used once their estimated footprint exceeds the memory budget.
+ * An evicted session stays valid for whoever still holds it.
+ * Thread-safe; a key being built by one thread is waited for, not built twice.
+ *
+ * Missing sessions can also be built on the registry's loader thread
+ * (loadAsync/prewarm), which runs one build at a time: user requests go ahead
+ * of queued prewarm jobs, and a cancelled build stops at its next stage.
+ */
+class ModelRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<IDetectionModel>()>;
+    using ProgressCallback = std::function<void(float progress)>;
+    using DoneCallback = std::function<void(std::shared_ptr<IDetectionModel> model, const char* error)>;
+
+    ModelRegistry(Factory factory, size_t budgetBytes);
+    ~ModelRegistry();
+
+    // Returns the session for config, building it on the calling thread on a miss.
+    // On failure returns nullptr and sets error. hit reports whether a live
+    // session was reused.
+    std::shared_ptr<IDetectionModel> acquire(const InferenceConfig& config,
+                                             const char** error = nullptr,
+                                             bool* hit = nullptr,
+                                             const IDetectionModel::LoadProgress& progress = {});
+
+    // Returns the live session for config and marks it most recently used, or
+    // nullptr without waiting or building if there is none.
+    std::shared_ptr<IDetectionModel> tryAcquire(const InferenceConfig& config);
+
+    // Builds (or fetches) the session on the loader thread. Callbacks run on the
+    // loader thread; onDone runs once, with kLoadCancelled if cancelled, unless
+    // the job was still queued at shutdown(). Returns 0 after shutdown().
+    uint64_t loadAsync(const InferenceConfig& config, ProgressCallback onProgress, DoneCallback onDone);
+    void cancel(uint64_t job);
+
+    // Queues background builds of the missing sessions behind any user request.
+    void prewarm(const std::vector<InferenceConfig>& configs);
+
+    // Cancels every job and joins the loader thread, so no callback runs after it
+    // returns; later loadAsync/prewarm calls are ignored. acquire() keeps working.
+    void shutdown();
+
+    bool contains(const InferenceConfig& config);
+    void setBudget(size_t budgetBytes);
+    size_t usedBytes();
+
+    static std::string keyFor(const InferenceConfig& config);
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<IDetectionModel> model;
+        size_t bytes = 0;
+    };
+
+    struct LoadJob {
+        uint64_t id = 0;
+        InferenceConfig config;
+        bool background = false;
+        std::atomic<bool> cancelled{false};
+        ProgressCallback onProgress;
+        DoneCallback onDone;
+    };
+
+    void insertLocked(const std::string& key, std::shared_ptr<IDetectionModel> model);
+    void evictLocked();
+    bool enqueue(std::shared_ptr<LoadJob> job);
+    void loaderLoop();
+
+    Factory m_factory;
+    size_t m_budgetBytes;
+    size_t m_usedBytes = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_buildDone;
+    std::list<Entry> m_lru; // front = most recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    std::unordered_set<std::string> m_building;
+
+    // Loader thread, guarded by m_jobMutex
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobReady;
+    std::deque<std::shared_ptr<LoadJob>> m_jobs;
+    std::shared_ptr<LoadJob> m_currentJob;
+    uint64_t m_nextJobId = 0;
+    bool m_stopLoader = false;
+    std::thread m_loaderThread;
+};
@@ -0,0 +1,214 @@
+#include "StagedPipeline.h"
+#include "../../../shared/infrastructure/ThreadNames.h"
+#include "../../../shared/infrastructure/Tracer.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t toMicros(Clock::duration d) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    }
+}
+
+void StagedPipeline::Counters::add(Clock::duration wait, Clock::duration busy)
+{
+    items.fetch_add(1, std::memory_order_relaxed);
+    waitUs.fetch_add(toMicros(wait), std::memory_order_relaxed);
+    busyUs.fetch_add(toMicros(busy), std::memory_order_relaxed);
+}
+
+void StagedPipeline::Counters::reset()
+{
+    items = 0;
+    busyUs = 0;
+    waitUs = 0;
+}
+
+StagedPipeline::StagedPipeline(FrameRing* ring, Options options, ResultCallback onResult, ErrorCallback onError)
+    : m_ring(ring)
+    , m_options(options)
+    , m_onResult(std::move(onResult))
+    , m_onError(std::move(onError))
+{
+}
+
+StagedPipeline::~StagedPipeline()
+{
+    stop();
+}
+
+void StagedPipeline::start(std::shared_ptr<IDetectionModel> model)
+{
+    stop();
+    if (!model || !m_ring) return;
+
+    m_model = std::move(model);
+    const size_t slots = static_cast<size_t>(m_model->maxInFlight());
+
+    m_freeSlots = std::make_unique<BoundedQueue<int>>(slots);
+    for (size_t i = 0; i < slots; ++i) m_freeSlots->push(static_cast<int>(i));
+    m_inferQueue = std::make_unique<BoundedQueue<Item>>(m_options.queueDepth, m_options.dropPolicy);
+    // Every slot fits, so runtime callbacks pushing here never block
+    m_postQueue = std::make_unique<BoundedQueue<Item>>(slots);
+
+    m_stopping = false;
+    m_nextSequence = 0;
+    m_lastEmittedSequence = 0;
+    m_preCounters.reset();
+    m_inferCounters.reset();
+    m_postCounters.reset();
+
+    m_threads.emplace_back(&StagedPipeline::preLoop, this);
+    m_threads.emplace_back(&StagedPipeline::inferLoop, this);
+    m_threads.emplace_back(&StagedPipeline::postLoop, this);
+}
+
+void StagedPipeline::stop()
+{
+    if (m_threads.empty()) return;
+    m_stopping = true;
+
+    // Shut down front to back so each stage drains what the previous one handed over
+    m_freeSlots->close();
+    m_ring->wake();
+    m_threads[0].join();
+
+    m_inferQueue->close();
+    m_threads[1].join();
+
+    m_model->waitForPending();
+    m_postQueue->close();
+    m_threads[2].join();
+
+    m_threads.clear();
+    m_model.reset();
+}
+
+void StagedPipeline::preLoop()
+{
+    ThreadNames::setCurrent("stage.pre");
+    while (!m_stopping) {
+        auto waitStart = Clock::now();
+
+        int slot = -1;
+        if (!m_freeSlots->pop(slot) || m_stopping) break;
+
+        int ringSlot = -1;
+        while (!m_stopping && (ringSlot = m_ring->tryAcquire()) < 0) {
+            m_ring->wait(std::chrono::milliseconds(5));
+        }
+        if (ringSlot < 0) break;
+
+        FrameRef frame = m_ring->frame(ringSlot);
+        FrameTrace trace = m_ring->trace(ringSlot);
+        trace.mark(FrameTrace::Dequeued);
+        m_ring->release(ringSlot);
+        if (!frame || frame->empty()) {
+            m_freeSlots->push(slot);
+            continue;
+        }
+
+        auto busyStart = Clock::now();
+        m_model->prepareInference(slot, *frame);
+        trace.mark(FrameTrace::Prepared);
+        Item item{slot, ++m_nextSequence, QSize(frame->cols, frame->rows), trace};
+        frame.reset();
+        m_preCounters.add(busyStart - waitStart, Clock::now() - busyStart);
+
+        std::optional<Item> dropped;
+        if (!m_inferQueue->push(item, &dropped)) {
+            m_model->releaseInference(slot);
+            break;
+        }
+        recycle(dropped);
+    }
+}
+
+void StagedPipeline::inferLoop()
+{
+    ThreadNames::setCurrent("stage.infer");
+    Item item;
+    while (true) {
+        auto waitStart = Clock::now();
+        if (!m_inferQueue->pop(item)) break;
+
+        if (m_stopping) {
+            m_model->releaseInference(item.slot);
+            continue;
+        }
+
+        // Asynchronous runtimes return at once and finish on their own threads;
+        // synchronous ones run the inference here
+        auto busyStart = Clock::now();
+        m_model->startPrepared(item.slot, [this, item](int) mutable {
+            item.trace.mark(FrameTrace::Inferred);
+            m_postQueue->push(item);
+        });
+        m_inferCounters.add(busyStart - waitStart, Clock::now() - busyStart);
+    }
+}
+
+void StagedPipeline::postLoop()
+{
+    ThreadNames::setCurrent("stage.post");
+    Item item;
+    while (true) {
+        auto waitStart = Clock::now();
+        if (!m_postQueue->pop(item)) break;
+
+        auto busyStart = Clock::now();
+        std::vector<DetectionResult> results;
+        InferenceTiming timing;
+        const char* status = m_model->completeInference(item.slot, results, timing);
+        m_freeSlots->push(item.slot);
+        timing.trace = item.trace;
+        timing.trace.mark(FrameTrace::PostProcessed);
+
+        if (m_stopping) continue;
+        if (status != nullptr) {
+            m_onError(status);
+        } else if (item.sequence > m_lastEmittedSequence) {
+            // Runtimes with several streams may finish out of order; never replace newer results
+            m_lastEmittedSequence = item.sequence;
+            timing.trace.mark(FrameTrace::Emitted);
+            m_onResult(results, timing, item.frameSize);
+        }
+        m_postCounters.add(busyStart - waitStart, Clock::now() - busyStart);
+    }
+}
+
+void StagedPipeline::recycle(const std::optional<Item>& dropped)
+{
+    if (!dropped) return;
+    m_model->releaseInference(dropped->slot);
+    m_freeSlots->push(dropped->slot);
+}
+
+StagedPipeline::Stats StagedPipeline::takeStats()
+{
+    auto fill = [](Counters& c, StageStats& s) {
+        s.items = c.items.exchange(0, std::memory_order_relaxed);
+        uint64_t busyUs = c.busyUs.exchange(0, std::memory_order_relaxed);
+        uint64_t waitUs = c.waitUs.exchange(0, std::memory_order_relaxed);
+        if (s.items > 0) {
+            s.avgBusyMs = busyUs / 1000.0 / s.items;
+            s.avgWaitMs = waitUs / 1000.0 / s.items;
+        }
+    };
+    auto fillQueue = [](const auto& queue, StageStats& s) {
+        if (!queue) return;
+        auto q = queue->stats();
+        s.queueDepth = q.depth;
+        s.queueCapacity = q.capacity;
+        s.dropped = q.dropped;
+    };
+
+    Stats stats;
+    fill(m_preCounters, stats.pre);
+    fill(m_inferCounters, stats.infer);
+    fill(m_postCounters, stats.post);
+    fillQueue(m_freeSlots, stats.pre);
+    fillQueue(m_inferQueue, stats.infer);
+    fillQueue(m_postQueue, stats.post);
+    return stats;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QSize>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "../domain/IDetectionModel.h"
+#include "../domain/DetectionResult.h"
+#include "../domain/InferenceTiming.h"
+#include "../../../shared/infrastructure/BoundedQueue.h"
+#include "../../../shared/infrastructure/FrameRing.h"
+
+/**
+ * @brief Runs pre-processing, inference and post-processing on their own threads.
+ *
+ * The pre stage takes the latest frame from the FrameRing into a free request slot,
+ * the infer stage starts the slot on the runtime, and the post stage post-processes
+ * finished slots and hands the results out. Stages are connected by BoundedQueues,
+ * so throughput is bounded by the slowest stage instead of the sum of all three.
+ *
+ * Slot ownership moves with the queues: free -> pre -> infer -> (runtime) -> post -> free.
+ */
+class StagedPipeline {
+public:
+    struct Options {
+        size_t queueDepth = 2;                                   // between pre and infer
+        QueueDropPolicy dropPolicy = QueueDropPolicy::Block;
+    };
+
+    struct StageStats {
+        uint64_t items = 0;
+        double avgBusyMs = 0.0;  // time spent working per item
+        double avgWaitMs = 0.0;  // time spent waiting for input per item
+        size_t queueDepth = 0;   // input queue occupancy
+        size_t queueCapacity = 0;
+        uint64_t dropped = 0;
+    };
+
+    struct Stats {
+        StageStats pre;
+        StageStats infer;
+        StageStats post;
+    };
+
+    using ResultCallback = std::function<void(std::vector<DetectionResult>& results,
+                                              const InferenceTiming& timing,
+                                              const QSize& frameSize)>;
+    using ErrorCallback = std::function<void(const char* error)>;
+
+    StagedPipeline(FrameRing* ring, Options options, ResultCallback onResult, ErrorCallback onError);
+    ~StagedPipeline();
+
+    StagedPipeline(const StagedPipeline&) = delete;
+    StagedPipeline& operator=(const StagedPipeline&) = delete;
+
+    void start(std::shared_ptr<IDetectionModel> model);
+    // Stops the stages and finishes in-flight slots; their results are discarded.
+    void stop();
+    bool isRunning() const { return !m_threads.empty(); }
+
+    // Stage times averaged since the previous call; queue figures are current
+    Stats takeStats();
+
+private:
+    struct Item {
+        int slot = -1;
+        uint64_t sequence = 0;
+        QSize frameSize;
+        FrameTrace trace;
+    };
+
+    struct Counters {
+        std::atomic<uint64_t> items{0};
+        std::atomic<uint64_t> busyUs{0};
+        std::atomic<uint64_t> waitUs{0};
+
+        void add(std::chrono::steady_clock::duration wait, std::chrono::steady_clock::duration busy);
+        void reset();
+    };
+
+    void preLoop();
+    void inferLoop();
+    void postLoop();
+    void recycle(const std::optional<Item>& dropped);
+
+    FrameRing* m_ring;
+    Options m_options;
+    ResultCallback m_onResult;
+    ErrorCallback m_onError;
+
+    std::shared_ptr<IDetectionModel> m_model;
+    std::unique_ptr<BoundedQueue<int>> m_freeSlots;
+    std::unique_ptr<BoundedQueue<Item>> m_inferQueue;
+    std::unique_ptr<BoundedQueue<Item>> m_postQueue;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<bool> m_stopping{false};
+    uint64_t m_nextSequence = 0;       // pre stage only
+    uint64_t m_lastEmittedSequence = 0; // post stage only
+
+    Counters m_preCounters;
+    Counters m_inferCounters;
+    Counters m_postCounters;
+};
@@ -3,17 +3,57 @@
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <string>
+#include <functional>
 #include "DetectionResult.h"
 #include "InferenceConfig.h"
 #include "InferenceTiming.h"
 
+// Returned by createSession() when the progress callback asked to stop
+inline constexpr const char* kLoadCancelled = "[YoloPipeline]: Load cancelled.";
+
 class IDetectionModel {
 public:
+    // Called with the load fraction [0, 1] between createSession() stages;
+    // returning false abandons the load.
+    using LoadProgress = std::function<bool(float progress)>;
+
     virtual ~IDetectionModel() = default;
-    virtual const char* createSession(const InferenceConfig& config) = 0;
+    virtual const char* createSession(const InferenceConfig& config, const LoadProgress& progress = {}) = 0;
+
+    // Rebuilds post-processing (thresholds, NMS) from config, leaving the session
+    // as it is. Cached sessions are shared across post-processing settings, so
+    // whoever takes one applies its own; only call with nothing in flight.
+    virtual const char* configurePostProcessing(const InferenceConfig& config) = 0;
+
     virtual char* runInference(const cv::Mat& frame,
                                std::vector<DetectionResult>& results,
                                InferenceTiming& timing) = 0;
+
+    // Pipelined execution. submitInference() preprocesses into a free request slot
+    // and starts inference without blocking, returning the slot (-1 if all are busy).
+    // onInferred(slot) is called from a runtime thread once outputs are ready; the
+    // caller then calls completeInference(slot, ...) on its own thread to
+    // post-process and free the slot.
+    virtual int maxInFlight() const = 0;
+    virtual int submitInference(const cv::Mat& frame, std::function<void(int slot)> onInferred) = 0;
+    virtual const char* completeInference(int slot,
+                                          std::vector<DetectionResult>& results,
+                                          InferenceTiming& timing) = 0;
+    // Blocks until every submitted inference has finished (not post-processed).
+    virtual void waitForPending() = 0;
+
+    // The same steps split up for a staged pipeline, where the caller owns slot
+    // allocation: prepareInference() preprocesses into the given free slot,
+    // startPrepared() starts it (onInferred as above), and releaseInference()
+    // frees a prepared slot that will not be run. Each may be called on a
+    // different thread as long as calls for one slot are ordered.
+    virtual void prepareInference(int slot, const cv::Mat& frame) = 0;
+    virtual void startPrepared(int slot, std::function<void(int slot)> onInferred) = 0;
+    virtual void releaseInference(int slot) = 0;
+
+    // Rough resident size of the session (weights plus I/O buffers), for cache budgeting.
+    virtual size_t memoryFootprint() const = 0;
+
     virtual const std::vector<std::string>& classNames() const = 0;
     virtual void warmUp() = 0;
 };
@@ -13,8 +13,54 @@ struct InferenceConfig {
     std::vector<int> imgSize = {640, 640};
     float confidenceThreshold = 0.4f;
     float iouThreshold        = 0.5f;
+    // Both modes keep exactly the same boxes; Grid skips comparisons between
+    // far-apart boxes. Class-aware NMS only lets a box suppress its own class.
+    YoloTask::NmsMode nmsMode = YoloTask::NmsMode::Greedy;
+    bool  classAgnosticNms    = true;
+    // Bounds on post-processing work (0 = unlimited): only the maxCandidates
+    // best-scoring anchors are decoded and go into NMS, which stops once
+    // maxDetections boxes are kept
+    int   maxCandidates       = 3000;
+    int   maxDetections       = 300;
     int   keyPointsNum        = 2; // Default for pose estimation if needed
     bool  cudaEnable          = false;
+    // OpenVINO only: CPU inference threads. ONNX Runtime always runs on the shared
+    // pool sized by TaskScheduler::runtimeThreadBudget().
     int   intraOpThreads      = std::max(1u, std::thread::hardware_concurrency() / 2);
     int   interOpThreads      = 1;
+    // OpenVINO only: fold BGR->RGB, 1/255 scaling and NHWC->NCHW into the compiled
+    // graph so the letterboxed u8 frame is fed as-is (no float blob on the CPU).
+    bool  embedPreprocessing  = true;
+    // OpenVINO only: LATENCY or THROUGHPUT compile hint; numStreams overrides the
+    // stream count for THROUGHPUT (0 = let the plugin decide).
+    YoloTask::PerformanceHint performanceHint = YoloTask::PerformanceHint::Latency;
+    int   numStreams          = 0;
+    std::string precision;             // OpenVINO inference precision hint ("f32", "bf16", "f16"); empty = plugin default
+    bool  useModelCache       = true;  // reuse compiled/optimized models from AppConfig::ModelCacheDir
 };
+
+// Bundled model for a task and runtime, relative to the working directory
+inline std::string defaultModelPath(YoloTask::TaskType task, YoloTask::RuntimeType runtime) {
+    std::string taskDir;
+    std::string modelName;
+
+    switch (task) {
+        case YoloTask::TaskType::ObjectDetection:
+            taskDir = "detection";
+            modelName = "yolov8n";
+            break;
+        case YoloTask::TaskType::PoseEstimation:
+            taskDir = "pose";
+            modelName = "yolov8n-pose";
+            break;
+        case YoloTask::TaskType::ImageSegmentation:
+            taskDir = "segmentation";
+            modelName = "yolov8n-seg";
+            break;
+    }
+
+    if (runtime == YoloTask::RuntimeType::OpenVINO) {
+        return "assets/openvino/" + taskDir + "/" + modelName + ".xml";
+    }
+    return "assets/onnx/" + taskDir + "/" + modelName + ".onnx";
+}
@@ -1,8 +1,19 @@
 #pragma once
 
+#include "../../../shared/domain/FrameTrace.h"
+#include "../../../shared/domain/HardwareCounters.h"
+
 struct InferenceTiming {
     double preProcess  = 0.0;
     double inference   = 0.0;
     double postProcess = 0.0;
     double total       = 0.0;
+
+    // CPU events during each stage (PerfCounters); invalid when unavailable
+    HardwareCounters preCounters;
+    HardwareCounters inferCounters;
+    HardwareCounters postCounters;
+
+    // The frame these results belong to, filled in by the inference worker
+    FrameTrace trace;
 };
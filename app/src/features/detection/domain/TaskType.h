@@ -17,4 +17,16 @@ namespace YoloTask {
         ONNXRuntime = 1
     };
     Q_ENUM_NS(RuntimeType)
+
+    enum class PerformanceHint {
+        Latency = 0,    // live camera: one stream, shortest time per frame
+        Throughput = 1  // offline video: several streams, most frames per second
+    };
+    Q_ENUM_NS(PerformanceHint)
+
+    enum class NmsMode {
+        Greedy = 0, // every kept box against every lower-scored candidate
+        Grid = 1    // only candidates sharing a cell of a coarse spatial grid (dense scenes)
+    };
+    Q_ENUM_NS(NmsMode)
 }
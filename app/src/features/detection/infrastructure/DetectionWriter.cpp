@@ -0,0 +1,155 @@
+#include "DetectionWriter.h"
+#include <cstdio>
+#include <iostream>
+
+namespace {
+    void appendJsonString(std::string& out, const std::string& text) {
+        out += '"';
+        for (char c : text) {
+            switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    // Quoted only when needed (RFC 4180)
+    void appendCsvField(std::string& out, const std::string& text) {
+        if (text.find_first_of(",\"\r\n") == std::string::npos) {
+            out += text;
+            return;
+        }
+        out += '"';
+        for (char c : text) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        out += '"';
+    }
+
+    void appendNumber(std::string& out, double value, const char* format = "%.4g") {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), format, value);
+        out += buffer;
+    }
+
+    std::string className(const std::vector<std::string>& classNames, int classId) {
+        if (classId >= 0 && classId < static_cast<int>(classNames.size())) return classNames[classId];
+        return std::to_string(classId);
+    }
+}
+
+DetectionWriter::~DetectionWriter()
+{
+    close();
+}
+
+const char* DetectionWriter::open(const std::string& path, Format format)
+{
+    close();
+    m_format = format;
+    if (path == "-") {
+        m_out = &std::cout;
+    } else {
+        m_file.open(path, std::ios::out | std::ios::trunc);
+        if (!m_file.is_open()) return "[DetectionWriter]: Cannot open output file.";
+        m_out = &m_file;
+    }
+
+    if (m_format == Format::Csv) {
+        *m_out << "source,frame,class_id,class,confidence,x,y,width,height\n";
+    }
+    return nullptr; // OK
+}
+
+void DetectionWriter::close()
+{
+    if (m_out) m_out->flush();
+    if (m_file.is_open()) m_file.close();
+    m_out = nullptr;
+}
+
+void DetectionWriter::write(const std::string& source, int64_t frameIndex,
+                            const std::vector<DetectionResult>& results,
+                            const std::vector<std::string>& classNames,
+                            const InferenceTiming& timing)
+{
+    if (!m_out) return;
+    m_line.clear();
+    if (m_format == Format::Csv) {
+        writeCsv(source, frameIndex, results, classNames);
+    } else {
+        writeJson(source, frameIndex, results, classNames, timing);
+    }
+    m_out->write(m_line.data(), static_cast<std::streamsize>(m_line.size()));
+}
+
+void DetectionWriter::writeJson(const std::string& source, int64_t frameIndex,
+                                const std::vector<DetectionResult>& results,
+                                const std::vector<std::string>& classNames,
+                                const InferenceTiming& timing)
+{
+    m_line += "{\"source\":";
+    appendJsonString(m_line, source);
+    m_line += ",\"frame\":" + std::to_string(frameIndex);
+    m_line += ",\"pre_ms\":";
+    appendNumber(m_line, timing.preProcess);
+    m_line += ",\"infer_ms\":";
+    appendNumber(m_line, timing.inference);
+    m_line += ",\"post_ms\":";
+    appendNumber(m_line, timing.postProcess);
+    m_line += ",\"detections\":[";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const DetectionResult& result = results[i];
+        if (i > 0) m_line += ',';
+        m_line += "{\"class_id\":" + std::to_string(result.classId) + ",\"class\":";
+        appendJsonString(m_line, className(classNames, result.classId));
+        m_line += ",\"confidence\":";
+        appendNumber(m_line, result.confidence);
+        m_line += ",\"box\":[" + std::to_string(result.box.x) + ',' + std::to_string(result.box.y) + ','
+                + std::to_string(result.box.width) + ',' + std::to_string(result.box.height) + ']';
+
+        if (!result.keyPoints.empty()) {
+            m_line += ",\"keypoints\":[";
+            for (size_t k = 0; k < result.keyPoints.size(); ++k) {
+                if (k > 0) m_line += ',';
+                m_line += '[';
+                appendNumber(m_line, result.keyPoints[k].x, "%.1f");
+                m_line += ',';
+                appendNumber(m_line, result.keyPoints[k].y, "%.1f");
+                m_line += ']';
+            }
+            m_line += ']';
+        }
+        m_line += '}';
+    }
+    m_line += "]}\n";
+}
+
+void DetectionWriter::writeCsv(const std::string& source, int64_t frameIndex,
+                               const std::vector<DetectionResult>& results,
+                               const std::vector<std::string>& classNames)
+{
+    for (const DetectionResult& result : results) {
+        appendCsvField(m_line, source);
+        m_line += ',' + std::to_string(frameIndex) + ',' + std::to_string(result.classId) + ',';
+        appendCsvField(m_line, className(classNames, result.classId));
+        m_line += ',';
+        appendNumber(m_line, result.confidence);
+        m_line += ',' + std::to_string(result.box.x) + ',' + std::to_string(result.box.y) + ','
+                + std::to_string(result.box.width) + ',' + std::to_string(result.box.height) + '\n';
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../domain/DetectionResult.h"
+#include "../domain/InferenceTiming.h"
+
+/**
+ * @brief Writes per-frame detections of a batch run as JSON Lines or CSV.
+ *
+ * JSON Lines: one object per frame (frames without detections included) with
+ * the stage times and every detection's class, confidence, box and keypoints.
+ * CSV: a header, then one row per detection; keypoints and masks are left out.
+ * Boxes are x, y, width, height in source-frame pixels.
+ */
+class DetectionWriter {
+public:
+    enum class Format { JsonLines, Csv };
+
+    ~DetectionWriter();
+
+    // "-" writes to stdout
+    const char* open(const std::string& path, Format format);
+    void close();
+
+    void write(const std::string& source, int64_t frameIndex,
+               const std::vector<DetectionResult>& results,
+               const std::vector<std::string>& classNames,
+               const InferenceTiming& timing);
+
+private:
+    void writeJson(const std::string& source, int64_t frameIndex,
+                   const std::vector<DetectionResult>& results,
+                   const std::vector<std::string>& classNames,
+                   const InferenceTiming& timing);
+    void writeCsv(const std::string& source, int64_t frameIndex,
+                  const std::vector<DetectionResult>& results,
+                  const std::vector<std::string>& classNames);
+
+    std::ofstream m_file;
+    std::ostream* m_out = nullptr;
+    Format m_format = Format::JsonLines;
+    std::string m_line; // reused per frame
+};
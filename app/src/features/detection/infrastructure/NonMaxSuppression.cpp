@@ -0,0 +1,164 @@
+#include "NonMaxSuppression.h"
+#include "SimdUtils.h"
+#include "../../../shared/infrastructure/Tracer.h"
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+namespace {
+constexpr int kMaxGridSide = 64; // cells per axis; larger extents get larger cells
+}
+
+void NonMaxSuppression::reserve(size_t candidates)
+{
+    m_order.reserve(candidates);
+    for (std::vector<float>* column : {&m_x1, &m_y1, &m_x2, &m_y2, &m_area}) column->reserve(candidates);
+    m_suppressed.reserve((candidates + 63) / 64);
+}
+
+int NonMaxSuppression::selectCandidates(int* indices, int count, const float* scores) const
+{
+    const int limit = m_options.maxCandidates;
+    if (limit <= 0 || count <= limit) return count;
+    std::nth_element(indices, indices + limit - 1, indices + count, [scores](int a, int b) {
+        return scores[a] > scores[b];
+    });
+    return limit;
+}
+
+void NonMaxSuppression::run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                            const std::vector<int>& classIds, std::vector<int>& keep)
+{
+    YOLO_TRACE_SCOPE("nms");
+    const int n = static_cast<int>(scores.size());
+    if (n == 0) return;
+
+    const bool byClass = !m_options.classAgnostic;
+    m_order.resize(n);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::sort(m_order.begin(), m_order.end(), [&](int a, int b) {
+        if (byClass && classIds[a] != classIds[b]) return classIds[a] < classIds[b];
+        return scores[a] > scores[b];
+    });
+
+    // Structure of arrays in score order, so the sweep below reads contiguous lanes
+    m_x1.resize(n);
+    m_y1.resize(n);
+    m_x2.resize(n);
+    m_y2.resize(n);
+    m_area.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const cv::Rect& box = boxes[m_order[i]];
+        m_x1[i] = static_cast<float>(box.x);
+        m_y1[i] = static_cast<float>(box.y);
+        m_x2[i] = static_cast<float>(box.x + box.width);
+        m_y2[i] = static_cast<float>(box.y + box.height);
+        m_area[i] = static_cast<float>(box.width) * static_cast<float>(box.height);
+    }
+
+    // Class buckets are disjoint ranges of one index space: bits and stamps left
+    // by one bucket are never read by the next, so both are reset once per run
+    if (m_options.mode == YoloTask::NmsMode::Grid) m_lastTested.assign(n, -1);
+    else m_suppressed.assign((n + 63) / 64, 0);
+
+    const size_t first = keep.size();
+    const int limit = m_options.maxDetections > 0 ? m_options.maxDetections : INT_MAX;
+    for (int begin = 0; begin < n;) {
+        int end = n;
+        if (byClass) {
+            end = begin + 1;
+            while (end < n && classIds[m_order[end]] == classIds[m_order[begin]]) ++end;
+        }
+        if (m_options.mode == YoloTask::NmsMode::Grid) sweepGrid(begin, end, limit, keep);
+        else sweep(begin, end, limit, keep);
+        begin = end;
+    }
+
+    // Buckets come out class by class; callers expect one score order
+    if (byClass) {
+        std::sort(keep.begin() + first, keep.end(), [&scores](int a, int b) { return scores[a] > scores[b]; });
+        if (keep.size() - first > static_cast<size_t>(limit)) keep.resize(first + limit);
+    }
+}
+
+void NonMaxSuppression::sweep(int begin, int end, int limit, std::vector<int>& keep)
+{
+    uint64_t* suppressed = m_suppressed.data();
+
+    int kept = 0;
+    for (int i = begin; i < end; ++i) {
+        if ((suppressed[i >> 6] >> (i & 63)) & 1) continue;
+        keep.push_back(m_order[i]);
+        if (++kept == limit) return;
+        simd::suppress_overlaps(m_x1.data(), m_y1.data(), m_x2.data(), m_y2.data(), m_area.data(),
+                                i + 1, end, i, m_options.iouThreshold, suppressed);
+    }
+}
+
+void NonMaxSuppression::sweepGrid(int begin, int end, int limit, std::vector<int>& keep)
+{
+    float minX = m_x1[begin], minY = m_y1[begin], maxX = m_x2[begin], maxY = m_y2[begin];
+    float sizeSum = 0.0f;
+    for (int i = begin; i < end; ++i) {
+        minX = std::min(minX, m_x1[i]);
+        minY = std::min(minY, m_y1[i]);
+        maxX = std::max(maxX, m_x2[i]);
+        maxY = std::max(maxY, m_y2[i]);
+        sizeSum += std::max(m_x2[i] - m_x1[i], m_y2[i] - m_y1[i]);
+    }
+
+    // Cells about the size of an average box, so most boxes cover 1-4 cells
+    const float extent = std::max(maxX - minX, maxY - minY);
+    const float cell = std::max({sizeSum / (end - begin), extent / (kMaxGridSide - 1), 1.0f});
+    const float invCell = 1.0f / cell;
+    const int cols = std::min(kMaxGridSide, static_cast<int>((maxX - minX) * invCell) + 1);
+    const int rows = std::min(kMaxGridSide, static_cast<int>((maxY - minY) * invCell) + 1);
+    auto cellOf = [](float v, float origin, float inv, int count) {
+        return std::min(count - 1, std::max(0, static_cast<int>((v - origin) * inv)));
+    };
+
+    m_cellHead.assign(static_cast<size_t>(cols) * rows, -1);
+    m_entryNext.clear();
+    m_entryBox.clear();
+    int keptCount = 0;
+
+    for (int i = begin; i < end; ++i) {
+        const int c0 = cellOf(m_x1[i], minX, invCell, cols), c1 = cellOf(m_x2[i], minX, invCell, cols);
+        const int r0 = cellOf(m_y1[i], minY, invCell, rows), r1 = cellOf(m_y2[i], minY, invCell, rows);
+
+        bool suppressed = false;
+        for (int r = r0; r <= r1 && !suppressed; ++r) {
+            for (int c = c0; c <= c1 && !suppressed; ++c) {
+                for (int e = m_cellHead[r * cols + c]; e >= 0; e = m_entryNext[e]) {
+                    const int kept = m_entryBox[e];
+                    if (m_lastTested[kept] == i) continue;
+                    m_lastTested[kept] = i;
+                    if (overlaps(kept, i)) {
+                        suppressed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (suppressed) continue;
+
+        keep.push_back(m_order[i]);
+        if (++keptCount == limit) return;
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                m_entryNext.push_back(m_cellHead[r * cols + c]);
+                m_entryBox.push_back(i);
+                m_cellHead[r * cols + c] = static_cast<int>(m_entryBox.size()) - 1;
+            }
+        }
+    }
+}
+
+bool NonMaxSuppression::overlaps(int a, int b) const
+{
+    // Same division-free test as simd::suppress_overlaps
+    const float w = std::max(0.0f, std::min(m_x2[a], m_x2[b]) - std::max(m_x1[a], m_x1[b]));
+    const float h = std::max(0.0f, std::min(m_y2[a], m_y2[b]) - std::max(m_y1[a], m_y1[b]));
+    const float inter = w * h;
+    return inter > m_options.iouThreshold * (m_area[a] + m_area[b] - inter);
+}
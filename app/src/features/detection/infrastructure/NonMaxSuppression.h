@@ -0,0 +1,71 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../domain/TaskType.h"
+
+/**
+ * @brief Greedy NMS shared by the post-processors.
+ *
+ * Candidates are copied once, in descending score order, into separate
+ * x1/y1/x2/y2/area float arrays so simd::suppress_overlaps can test one kept box
+ * against 8 or 16 others per instruction. Suppression is a packed bitset, and
+ * the IoU test is division-free. Buffers are kept between calls, so a steady
+ * stream of frames does not allocate.
+ *
+ * Class-aware NMS sorts by class first and runs each class as its own bucket.
+ * Grid mode replaces the all-pairs sweep: kept boxes are registered in the cells
+ * of a coarse grid they cover, and a candidate is only tested against kept boxes
+ * in its own cells. Overlapping boxes always share a cell, so the result is the
+ * same as Greedy while the cost stays near-linear for thousands of small boxes.
+ *
+ * With maxDetections set, a class-agnostic sweep stops as soon as that many
+ * boxes are kept; class-aware buckets are each capped and the merged result is
+ * cut to the best maxDetections.
+ */
+class NonMaxSuppression {
+public:
+    struct Options {
+        YoloTask::NmsMode mode = YoloTask::NmsMode::Greedy;
+        bool  classAgnostic = true;
+        float iouThreshold  = 0.5f;
+        int   maxCandidates = 0; // 0 = unlimited
+        int   maxDetections = 0;
+    };
+
+    NonMaxSuppression() = default;
+    explicit NonMaxSuppression(const Options& options) : m_options(options) {}
+
+    void reserve(size_t candidates);
+
+    // Cuts the anchor indices above the confidence threshold down to the
+    // maxCandidates best by score (unordered, O(n)); returns the new count
+    int selectCandidates(int* indices, int count, const float* scores) const;
+
+    // Appends the indices of the kept boxes to `keep`, highest score first
+    void run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+             const std::vector<int>& classIds, std::vector<int>& keep);
+
+private:
+    // Each stops once `limit` boxes of the range are kept
+    void sweep(int begin, int end, int limit, std::vector<int>& keep);
+    void sweepGrid(int begin, int end, int limit, std::vector<int>& keep);
+    bool overlaps(int a, int b) const;
+
+    Options m_options;
+    std::vector<int> m_order;
+    std::vector<float> m_x1;
+    std::vector<float> m_y1;
+    std::vector<float> m_x2;
+    std::vector<float> m_y2;
+    std::vector<float> m_area;
+    std::vector<uint64_t> m_suppressed;
+
+    // Grid mode: per-cell singly linked lists of kept boxes
+    std::vector<int> m_cellHead;
+    std::vector<int> m_entryNext;
+    std::vector<int> m_entryBox;
+    std::vector<int> m_lastTested; // candidate that last tested each kept box, to skip repeats
+};
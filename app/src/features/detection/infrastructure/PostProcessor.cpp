@@ -1,500 +1,271 @@
 #include "PostProcessor.h"
 #include "SimdUtils.h"
-#include <numeric>
+#include "../../../shared/infrastructure/TaskScheduler.h"
+#include "../../../shared/infrastructure/Tracer.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <QDebug>
 
-// ============================================================================
-// DetectionPostProcessor
-// ============================================================================
+namespace {
+constexpr int kScoreChunk = 1024; // anchors per scheduler task in the class-score reduction
+
+// Best class per anchor, in column chunks on the shared scheduler
+void reduceBestScores(const float* classScores, int numClasses, int strideNum,
+                      float* bestScores, int* bestClassIds) {
+    TaskScheduler::global().parallelFor(0, strideNum, kScoreChunk, [=](int begin, int end) {
+        const int count = end - begin;
+        memcpy(bestScores + begin, classScores + begin, count * sizeof(float));
+        memset(bestClassIds + begin, 0, count * sizeof(int));
+        for (int c = 1; c < numClasses; ++c) {
+            simd::update_best_scores(classScores + c * strideNum + begin, bestScores + begin, bestClassIds + begin, c, count);
+        }
+    });
+}
+}
 
-DetectionPostProcessor::DetectionPostProcessor(YoloTask::TaskType taskType, float rectConfidenceThreshold, float iouThreshold)
-    : m_taskType(taskType), m_rectConfidenceThreshold(rectConfidenceThreshold), m_iouThreshold(iouThreshold) {}
+template <YoloTask::TaskType Task, int Classes, int KeyPoints, int MaskCoeffs>
+YoloPostProcessor<Task, Classes, KeyPoints, MaskCoeffs>::YoloPostProcessor(float rectConfidenceThreshold, const NonMaxSuppression::Options& nms)
+    : m_rectConfidenceThreshold(rectConfidenceThreshold), m_nms(nms)
+{
+    static_assert(Classes != kDynamicCount || KeyPoints != kDynamicCount, "class and keypoint counts cannot both be inferred");
+    static_assert(kPose || KeyPoints == 0, "only pose heads carry keypoints");
+    static_assert(kSegmentation || MaskCoeffs == 0, "only segmentation heads carry mask coefficients");
+}
 
-void DetectionPostProcessor::initBuffers(size_t strideNum) {
+template <YoloTask::TaskType Task, int Classes, int KeyPoints, int MaskCoeffs>
+void YoloPostProcessor<Task, Classes, KeyPoints, MaskCoeffs>::initBuffers(size_t strideNum) {
     m_bestScores.resize(strideNum);
     m_bestClassIds.resize(strideNum);
+    m_candidateIndices.resize(strideNum);
     m_classIds.reserve(256);
     m_confidences.reserve(256);
     m_boxes.reserve(256);
     m_nmsIndices.reserve(64);
-    m_sortIndices.reserve(256);
+    m_nms.reserve(256);
 }
 
-void DetectionPostProcessor::postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult> &oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput, const std::vector<int64_t>& secondaryDims) {
-    int signalResultNum = outputNodeDims[1]; 
-    int strideNum = outputNodeDims[2];       
-    int numClasses = signalResultNum - 4;    
+template <YoloTask::TaskType Task, int Classes, int KeyPoints, int MaskCoeffs>
+void YoloPostProcessor<Task, Classes, KeyPoints, MaskCoeffs>::postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult> &oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput, const std::vector<int64_t>& secondaryDims) {
+    YOLO_TRACE_SCOPE(kPose ? "post.pose" : kSegmentation ? "post.segmentation" : "post.detection");
+    const int signalResultNum = static_cast<int>(outputNodeDims[1]);
+    const int strideNum = static_cast<int>(outputNodeDims[2]);
+
+    int maskCoeffs = 0;
+    if constexpr (kSegmentation) {
+        if (!secondaryOutput || secondaryDims.size() < 4) {
+            qDebug() << "[YOLO]: Segmentation requires secondary output tensor! Output is null.";
+            return;
+        }
+        maskCoeffs = static_cast<int>(secondaryDims[1]);
+    }
 
-    float* data = static_cast<float*>(output);
+    // Whichever count is not fixed follows from the row count
+    int numClasses = Classes;
+    int numKeyPoints = KeyPoints;
+    if constexpr (Classes == kDynamicCount) numClasses = signalResultNum - 4 - 3 * KeyPoints - maskCoeffs;
+    if constexpr (KeyPoints == kDynamicCount) numKeyPoints = (signalResultNum - 4 - Classes) / 3;
+    if (numClasses < 1 || 4 + numClasses + 3 * numKeyPoints + maskCoeffs != signalResultNum) {
+        qDebug() << "[YOLO]: Output has" << signalResultNum << "rows, expected 4 box +" << numClasses << "classes +"
+                 << numKeyPoints << "keypoints x3 +" << maskCoeffs << "mask coefficients.";
+        return;
+    }
+    if (m_candidateIndices.size() < static_cast<size_t>(strideNum)) initBuffers(strideNum);
 
-    float* row0 = data + 4 * strideNum;
-    memcpy(m_bestScores.data(), row0, strideNum * sizeof(float));
-    memset(m_bestClassIds.data(), 0, strideNum * sizeof(int));
+    float* data = static_cast<float*>(output);
 
-    for (int c = 1; c < numClasses; ++c) {
-        simd::update_best_scores_sse41(data + (4 + c) * strideNum, m_bestScores.data(), m_bestClassIds.data(), c, strideNum);
+    // Single-class heads (pose) use their score row as is
+    const float* scores = data + 4 * strideNum;
+    const int* classIds = nullptr;
+    if (numClasses > 1) {
+        reduceBestScores(scores, numClasses, strideNum, m_bestScores.data(), m_bestClassIds.data());
+        scores = m_bestScores.data();
+        classIds = m_bestClassIds.data();
     }
 
     m_classIds.clear();
     m_confidences.clear();
     m_boxes.clear();
 
-    const float* bestS = m_bestScores.data();
-    const int*   bestC = m_bestClassIds.data();
+    int numCandidates = simd::collect_above_threshold(scores, strideNum, m_rectConfidenceThreshold, m_candidateIndices.data());
+    numCandidates = m_nms.selectCandidates(m_candidateIndices.data(), numCandidates, scores);
+    for (int i = 0; i < numCandidates; ++i) {
+        int idx = m_candidateIndices[i];
+        m_confidences.push_back(scores[idx]);
+        m_classIds.push_back(classIds ? classIds[idx] : 0);
 
-    int j = 0;
-    for (; j <= strideNum - 4; j += 4) {
-        int mask = simd::check_threshold_sse41(bestS + j, m_rectConfidenceThreshold);
-        if (mask == 0) continue; 
+        float cx = data[0 * strideNum + idx];
+        float cy = data[1 * strideNum + idx];
+        float bw = data[2 * strideNum + idx];
+        float bh = data[3 * strideNum + idx];
 
-        for (int k = 0; k < 4; ++k) {
-            if (mask & (1 << k)) {
-                int idx = j + k;
-                m_confidences.push_back(bestS[idx]);
-                m_classIds.push_back(bestC[idx]);
+        int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
+        int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
+        int width  = static_cast<int>(bw * info.scale);
+        int height = static_cast<int>(bh * info.scale);
 
-                float cx = data[0 * strideNum + idx];
-                float cy = data[1 * strideNum + idx];
-                float bw = data[2 * strideNum + idx];
-                float bh = data[3 * strideNum + idx];
-
-                int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
-                int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
-                int width  = static_cast<int>(bw * info.scale);
-                int height = static_cast<int>(bh * info.scale);
-
-                m_boxes.emplace_back(left, top, width, height);
-            }
-        }
-    }
-
-    for (; j < strideNum; ++j) {
-        if (bestS[j] > m_rectConfidenceThreshold) {
-            m_confidences.push_back(bestS[j]);
-            m_classIds.push_back(bestC[j]);
-
-            float cx = data[0 * strideNum + j];
-            float cy = data[1 * strideNum + j];
-            float bw = data[2 * strideNum + j];
-            float bh = data[3 * strideNum + j];
-
-            int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
-            int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
-            int width  = static_cast<int>(bw * info.scale);
-            int height = static_cast<int>(bh * info.scale);
-
-            m_boxes.emplace_back(left, top, width, height);
-        }
+        m_boxes.emplace_back(left, top, width, height);
     }
 
     m_nmsIndices.clear();
-    greedyNMS(m_iouThreshold);
+    m_nms.run(m_boxes, m_confidences, m_classIds, m_nmsIndices);
+    if (m_nmsIndices.empty()) return;
 
+    // Keypoint and mask-coefficient rows follow the class scores
+    const float* extraRows = data + (4 + numClasses) * strideNum;
+    const size_t first = oResult.size();
+    oResult.resize(first + m_nmsIndices.size());
     for (size_t i = 0; i < m_nmsIndices.size(); ++i) {
         int idx = m_nmsIndices[i];
-        DetectionResult result;
+        DetectionResult& result = oResult[first + i];
         result.classId    = m_classIds[idx];
         result.confidence = m_confidences[idx];
         result.box        = m_boxes[idx];
-        oResult.push_back(result);
-    }
-}
-
-void DetectionPostProcessor::greedyNMS(float iouThresh) {
-    int n = static_cast<int>(m_confidences.size());
-    if (n == 0) return;
-    
-    m_sortIndices.resize(n);
-    std::iota(m_sortIndices.begin(), m_sortIndices.end(), 0);
-    std::sort(m_sortIndices.begin(), m_sortIndices.end(),
-              [this](int a, int b) {
-                  return m_confidences[a] > m_confidences[b];
-              });
-    
-    m_suppressed.assign(n, false);
-    
-    for (int i = 0; i < n; ++i) {
-        int idx = m_sortIndices[i];
-        if (m_suppressed[idx]) continue;    
-        
-        m_nmsIndices.push_back(idx);        
-        
-        const cv::Rect& a = m_boxes[idx];
-        float areaA = static_cast<float>(a.width * a.height);
-        
-        for (int k = i + 1; k < n; ++k) {
-            int kidx = m_sortIndices[k];
-            if (m_suppressed[kidx]) continue;
-            
-            const cv::Rect& b = m_boxes[kidx];
-            
-            int x1 = std::max(a.x, b.x);
-            int y1 = std::max(a.y, b.y);
-            int x2 = std::min(a.x + a.width,  b.x + b.width);
-            int y2 = std::min(a.y + a.height, b.y + b.height);
-            
-            if (x2 <= x1 || y2 <= y1) continue;
-            
-            float intersection = static_cast<float>((x2 - x1) * (y2 - y1));
-            float areaB = static_cast<float>(b.width * b.height);
-            float unionArea = areaA + areaB - intersection;
-            float iou = intersection / unionArea;
-            
-            if (iou > iouThresh) {
-                m_suppressed[kidx] = true;  
-            }
+        if constexpr (kPose) {
+            decodeKeyPoints(extraRows, strideNum, m_candidateIndices[idx], numKeyPoints, info, result.keyPoints);
         }
     }
-}
-
 
-// ============================================================================
-// PosePostProcessor
-// ============================================================================
-
-PosePostProcessor::PosePostProcessor(YoloTask::TaskType taskType, float rectConfidenceThreshold, float iouThreshold)
-    : m_taskType(taskType), m_rectConfidenceThreshold(rectConfidenceThreshold), m_iouThreshold(iouThreshold) {}
-
-void PosePostProcessor::initBuffers(size_t strideNum) {
-    m_bestScores.resize(strideNum);
-    m_bestClassIds.resize(strideNum);
-    m_classIds.reserve(256);
-    m_confidences.reserve(256);
-    m_boxes.reserve(256);
-    m_nmsIndices.reserve(64);
-    m_sortIndices.reserve(256);
+    if constexpr (kSegmentation) {
+        decodeMasks(extraRows, strideNum, maskCoeffs, oResult.data() + first, info, secondaryOutput, secondaryDims);
+    }
 }
 
-void PosePostProcessor::postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult> &oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput, const std::vector<int64_t>& secondaryDims) {
-    int strideNum = outputNodeDims[2];       
-
-    float* data = static_cast<float*>(output);
-
-    m_classIds.clear();
-    m_confidences.clear();
-    m_boxes.clear();
-    m_keypoints.clear();
-
-    int j = 0;
-    for (; j <= strideNum - 4; j += 4) {
-        int mask = simd::check_threshold_sse41(data + 4 * strideNum + j, m_rectConfidenceThreshold);
-        if (mask == 0) continue;
-
-        for (int k = 0; k < 4; ++k) {
-            if (mask & (1 << k)) {
-                int idx = j + k;
-                float score = data[4 * strideNum + idx];
-                m_confidences.push_back(score);
-                m_classIds.push_back(0);
-
-                float cx = data[0 * strideNum + idx];
-                float cy = data[1 * strideNum + idx];
-                float bw = data[2 * strideNum + idx];
-                float bh = data[3 * strideNum + idx];
-
-                int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
-                int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
-                int width  = static_cast<int>(bw * info.scale);
-                int height = static_cast<int>(bh * info.scale);
-
-                m_boxes.emplace_back(left, top, width, height);
-                
-                std::vector<cv::Point2f> kpts;
-                for(int kp=0; kp<17; kp++) {
-                    float kx = data[(5 + kp*3) * strideNum + idx];
-                    float ky = data[(5 + kp*3 + 1) * strideNum + idx];
-                    kpts.push_back(cv::Point2f((kx - info.padW) * info.scale, (ky - info.padH) * info.scale));
-                }
-                m_keypoints.push_back(kpts);
-            }
-        }
+template <YoloTask::TaskType Task, int Classes, int KeyPoints, int MaskCoeffs>
+void YoloPostProcessor<Task, Classes, KeyPoints, MaskCoeffs>::decodeKeyPoints(const float* rows, int strideNum, int anchor, int keyPoints,
+                                                                              const LetterboxInfo& info, std::vector<cv::Point2f>& out) const {
+    // A literal trip count for the fixed layouts
+    const int count = KeyPoints != kDynamicCount ? KeyPoints : keyPoints;
+    out.resize(count);
+    for (int kp = 0; kp < count; ++kp) {
+        float kx = rows[(kp * 3) * strideNum + anchor];
+        float ky = rows[(kp * 3 + 1) * strideNum + anchor];
+        out[kp] = cv::Point2f((kx - info.padW) * info.scale, (ky - info.padH) * info.scale);
     }
+}
 
-    for (; j < strideNum; ++j) {
-        float score = data[4 * strideNum + j];
-        if (score > m_rectConfidenceThreshold) {
-            m_confidences.push_back(score);
-            m_classIds.push_back(0); 
-
-            float cx = data[0 * strideNum + j];
-            float cy = data[1 * strideNum + j];
-            float bw = data[2 * strideNum + j];
-            float bh = data[3 * strideNum + j];
-
-            int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
-            int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
-            int width  = static_cast<int>(bw * info.scale);
-            int height = static_cast<int>(bh * info.scale);
-
-            m_boxes.emplace_back(left, top, width, height);
-            
-            std::vector<cv::Point2f> kpts;
-            for(int k=0; k<17; k++) {
-                float kx = data[(5 + k*3) * strideNum + j];
-                float ky = data[(5 + k*3 + 1) * strideNum + j];
-                kpts.push_back(cv::Point2f((kx - info.padW) * info.scale, (ky - info.padH) * info.scale));
-            }
-            m_keypoints.push_back(kpts);
+template <YoloTask::TaskType Task, int Classes, int KeyPoints, int MaskCoeffs>
+void YoloPostProcessor<Task, Classes, KeyPoints, MaskCoeffs>::decodeMasks(const float* coeffRows, int strideNum, int maskCoeffs, DetectionResult* results,
+                                                                          const LetterboxInfo& info, void* protoOutput, const std::vector<int64_t>& protoDims) {
+    const int maskChannels = MaskCoeffs != kDynamicCount ? MaskCoeffs : maskCoeffs;
+    const int maskH = static_cast<int>(protoDims[2]);
+    const int maskW = static_cast<int>(protoDims[3]);
+    const int kept = static_cast<int>(m_nmsIndices.size());
+
+    // Gather the kept detections' coefficients into contiguous rows
+    m_maskCoeffs.resize(static_cast<size_t>(kept) * maskChannels);
+    for (int i = 0; i < kept; ++i) {
+        const int anchor = m_candidateIndices[m_nmsIndices[i]];
+        float* coeffs = m_maskCoeffs.data() + static_cast<size_t>(i) * maskChannels;
+        for (int m = 0; m < maskChannels; ++m) {
+            coeffs[m] = coeffRows[m * strideNum + anchor];
         }
     }
 
-    m_nmsIndices.clear();
-    greedyNMS(m_iouThreshold);
-
-    for (size_t i = 0; i < m_nmsIndices.size(); ++i) {
-        int idx = m_nmsIndices[i];
-        DetectionResult result;
-        result.classId    = m_classIds[idx];
-        result.confidence = m_confidences[idx];
-        result.box        = m_boxes[idx];
-        result.keyPoints  = m_keypoints[idx];
-        oResult.push_back(result);
-    }
-}
-
-void PosePostProcessor::greedyNMS(float iouThresh) {
-    int n = static_cast<int>(m_confidences.size());
-    if (n == 0) return;
-    
-    m_sortIndices.resize(n);
-    std::iota(m_sortIndices.begin(), m_sortIndices.end(), 0);
-    std::sort(m_sortIndices.begin(), m_sortIndices.end(),
-              [this](int a, int b) {
-                  return m_confidences[a] > m_confidences[b];
-              });
-    
-    m_suppressed.assign(n, false);
-    
-    for (int i = 0; i < n; ++i) {
-        int idx = m_sortIndices[i];
-        if (m_suppressed[idx]) continue;    
-        
-        m_nmsIndices.push_back(idx);        
-        
-        const cv::Rect& a = m_boxes[idx];
-        float areaA = static_cast<float>(a.width * a.height);
-        
-        for (int k = i + 1; k < n; ++k) {
-            int kidx = m_sortIndices[k];
-            if (m_suppressed[kidx]) continue;
-            
-            const cv::Rect& b = m_boxes[kidx];
-            
-            int x1 = std::max(a.x, b.x);
-            int y1 = std::max(a.y, b.y);
-            int x2 = std::min(a.x + a.width,  b.x + b.width);
-            int y2 = std::min(a.y + a.height, b.y + b.height);
-            
-            if (x2 <= x1 || y2 <= y1) continue;
-            
-            float intersection = static_cast<float>((x2 - x1) * (y2 - y1));
-            float areaB = static_cast<float>(b.width * b.height);
-            float unionArea = areaA + areaB - intersection;
-            float iou = intersection / unionArea;
-            
-            if (iou > iouThresh) {
-                m_suppressed[kidx] = true;  
+    const float* protoData = static_cast<const float*>(protoOutput);
+    const size_t protoPlane = static_cast<size_t>(maskH) * maskW;
+
+    // The proto map is a quarter of the letterboxed input; its unpadded part
+    // scaled to frame space is the area masks are clipped to, as before
+    const cv::Rect frameRect(0, 0, static_cast<int>((maskW * 4 - 2 * info.padW) * info.scale),
+                             static_cast<int>((maskH * 4 - 2 * info.padH) * info.scale));
+    const float frameToProto = 0.25f / info.scale;
+
+    // One mask per scheduler task; each works on its own matrices
+    TaskScheduler::global().parallelFor(0, kept, 1, [&](int begin, int end) {
+        cv::Mat cropMat;
+        cv::Mat cropResized;
+        for (int i = begin; i < end; ++i) {
+            DetectionResult& result = results[i];
+            result.boxMask = cv::Mat();
+
+            const cv::Rect clipBox = result.box & frameRect;
+            if (clipBox.width <= 0 || clipBox.height <= 0) continue;
+
+            // Box in proto cells, with one cell of margin so the edges interpolate
+            // against their neighbours like the full-map upsample did
+            const int px0 = std::max(0, static_cast<int>(std::floor((clipBox.x + info.padW * info.scale) * frameToProto)) - 1);
+            const int py0 = std::max(0, static_cast<int>(std::floor((clipBox.y + info.padH * info.scale) * frameToProto)) - 1);
+            const int px1 = std::min(maskW, static_cast<int>(std::ceil((clipBox.x + clipBox.width + info.padW * info.scale) * frameToProto)) + 1);
+            const int py1 = std::min(maskH, static_cast<int>(std::ceil((clipBox.y + clipBox.height + info.padH * info.scale) * frameToProto)) + 1);
+            if (px1 <= px0 || py1 <= py0) continue;
+            const int cropW = px1 - px0;
+            const int cropH = py1 - py0;
+
+            // Coefficients x prototypes over the crop only, channel by channel so
+            // every row is a contiguous multiply-add
+            const float* coeffs = m_maskCoeffs.data() + static_cast<size_t>(i) * maskChannels;
+            cropMat.create(cropH, cropW, CV_32F);
+            cropMat.setTo(0.0f);
+            for (int m = 0; m < maskChannels; ++m) {
+                const float c = coeffs[m];
+                const float* plane = protoData + m * protoPlane + static_cast<size_t>(py0) * maskW + px0;
+                for (int y = 0; y < cropH; ++y) {
+                    const float* src = plane + static_cast<size_t>(y) * maskW;
+                    float* dst = cropMat.ptr<float>(y);
+                    for (int x = 0; x < cropW; ++x) dst[x] += c * src[x];
+                }
             }
+            cv::exp(-cropMat, cropMat);
+            cropMat = 1.0 / (1.0 + cropMat);
+
+            // Straight to frame scale, then cut out the box
+            const float cropScale = 4.0f * info.scale;
+            const cv::Size frameSize(static_cast<int>(std::ceil(cropW * cropScale)), static_cast<int>(std::ceil(cropH * cropScale)));
+            if (frameSize.width < clipBox.width || frameSize.height < clipBox.height) continue;
+            cv::resize(cropMat, cropResized, frameSize);
+
+            const int offsetX = std::clamp(cvRound(clipBox.x - (px0 * 4 - info.padW) * info.scale), 0, frameSize.width - clipBox.width);
+            const int offsetY = std::clamp(cvRound(clipBox.y - (py0 * 4 - info.padH) * info.scale), 0, frameSize.height - clipBox.height);
+            result.boxMask = cropResized(cv::Rect(offsetX, offsetY, clipBox.width, clipBox.height)) > 0.5f;
         }
-    }
+    });
 }
 
 // ============================================================================
-// SegmentationPostProcessor
+// Instantiations
 // ============================================================================
 
-SegmentationPostProcessor::SegmentationPostProcessor(YoloTask::TaskType taskType, float rectConfidenceThreshold, float iouThreshold)
-    : m_taskType(taskType), m_rectConfidenceThreshold(rectConfidenceThreshold), m_iouThreshold(iouThreshold) {}
-
-void SegmentationPostProcessor::initBuffers(size_t strideNum) {
-    m_bestScores.resize(strideNum);
-    m_bestClassIds.resize(strideNum);
-    m_classIds.reserve(256);
-    m_confidences.reserve(256);
-    m_boxes.reserve(256);
-    m_nmsIndices.reserve(64);
-    m_sortIndices.reserve(256);
-}
-
-void SegmentationPostProcessor::postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult> &oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput, const std::vector<int64_t>& secondaryDims) {
-    if (!secondaryOutput) {
-        qDebug() << "[YOLO]: Segmentation requires secondary output tensor! Output is null.";
-        return;
-    }
-
-    int signalResultNum = outputNodeDims[1]; 
-    int strideNum = outputNodeDims[2];       
-    int numClasses = signalResultNum - 4 - 32; 
-
-    float* data = static_cast<float*>(output);
-
-    float* row0 = data + 4 * strideNum;
-    memcpy(m_bestScores.data(), row0, strideNum * sizeof(float));
-    memset(m_bestClassIds.data(), 0, strideNum * sizeof(int));
-
-    for (int c = 1; c < numClasses; ++c) {
-        simd::update_best_scores_sse41(data + (4 + c) * strideNum, m_bestScores.data(), m_bestClassIds.data(), c, strideNum);
-    }
-
-    m_classIds.clear();
-    m_confidences.clear();
-    m_boxes.clear();
-    m_maskCoeffs.clear();
-
-    const float* bestS = m_bestScores.data();
-    const int*   bestC = m_bestClassIds.data();
-
-    int coeffOffset = 4 + numClasses; 
-
-    int j = 0;
-    for (; j <= strideNum - 4; j += 4) {
-        int mask = simd::check_threshold_sse41(bestS + j, m_rectConfidenceThreshold);
-        if (mask == 0) continue;
-
-        for (int k = 0; k < 4; ++k) {
-            if (mask & (1 << k)) {
-                int idx = j + k;
-                m_confidences.push_back(bestS[idx]);
-                m_classIds.push_back(bestC[idx]);
-
-                float cx = data[0 * strideNum + idx];
-                float cy = data[1 * strideNum + idx];
-                float bw = data[2 * strideNum + idx];
-                float bh = data[3 * strideNum + idx];
-
-                int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
-                int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
-                int width  = static_cast<int>(bw * info.scale);
-                int height = static_cast<int>(bh * info.scale);
-
-                m_boxes.emplace_back(left, top, width, height);
-
-                std::vector<float> coeffs(32);
-                for (int m = 0; m < 32; ++m) {
-                    coeffs[m] = data[(coeffOffset + m) * strideNum + idx];
-                }
-                m_maskCoeffs.push_back(coeffs);
-            }
-        }
-    }
-
-    for (; j < strideNum; ++j) {
-        if (bestS[j] > m_rectConfidenceThreshold) {
-            m_confidences.push_back(bestS[j]);
-            m_classIds.push_back(bestC[j]);
-
-            float cx = data[0 * strideNum + j];
-            float cy = data[1 * strideNum + j];
-            float bw = data[2 * strideNum + j];
-            float bh = data[3 * strideNum + j];
-
-            int left   = static_cast<int>((cx - 0.5f * bw - info.padW) * info.scale);
-            int top    = static_cast<int>((cy - 0.5f * bh - info.padH) * info.scale);
-            int width  = static_cast<int>(bw * info.scale);
-            int height = static_cast<int>(bh * info.scale);
-
-            m_boxes.emplace_back(left, top, width, height);
-
-            std::vector<float> coeffs(32);
-            for (int m = 0; m < 32; ++m) {
-                coeffs[m] = data[(coeffOffset + m) * strideNum + j];
+template class YoloPostProcessor<YoloTask::TaskType::ObjectDetection, 80, 0, 0>;
+template class YoloPostProcessor<YoloTask::TaskType::PoseEstimation, 1, 17, 0>;
+template class YoloPostProcessor<YoloTask::TaskType::ImageSegmentation, 80, 0, 32>;
+template class YoloPostProcessor<YoloTask::TaskType::ObjectDetection, kDynamicCount, 0, 0>;
+template class YoloPostProcessor<YoloTask::TaskType::PoseEstimation, 1, kDynamicCount, 0>;
+template class YoloPostProcessor<YoloTask::TaskType::ImageSegmentation, kDynamicCount, 0, kDynamicCount>;
+
+std::unique_ptr<IPostProcessor> createPostProcessor(YoloTask::TaskType task, const std::vector<int64_t>& outputShape,
+                                                    float rectConfidenceThreshold, const NonMaxSuppression::Options& nms) {
+    const int64_t rows = outputShape.size() >= 3 ? outputShape[1] : -1;
+    std::unique_ptr<IPostProcessor> processor;
+    bool fixedLayout = true;
+
+    switch (task) {
+        case YoloTask::TaskType::ObjectDetection:
+            if (rows == 4 + 80) {
+                processor = std::make_unique<CocoDetectionPostProcessor>(rectConfidenceThreshold, nms);
+            } else {
+                processor = std::make_unique<YoloPostProcessor<YoloTask::TaskType::ObjectDetection, kDynamicCount, 0, 0>>(rectConfidenceThreshold, nms);
+                fixedLayout = false;
             }
-            m_maskCoeffs.push_back(coeffs);
-        }
-    }
-
-    m_nmsIndices.clear();
-    greedyNMS(m_iouThreshold);
-
-    if (!m_nmsIndices.empty() && secondaryOutput != nullptr) {
-        int maskChannels = secondaryDims[1]; 
-        int maskH = secondaryDims[2];        
-        int maskW = secondaryDims[3];        
-
-        float* protoData = static_cast<float*>(secondaryOutput);
-        m_protoMat = cv::Mat(maskChannels, maskH * maskW, CV_32F, protoData);
-
-        for (size_t i = 0; i < m_nmsIndices.size(); ++i) {
-            int idx = m_nmsIndices[i];
-            DetectionResult result;
-            result.classId    = m_classIds[idx];
-            result.confidence = m_confidences[idx];
-            result.box        = m_boxes[idx];
-
-            cv::Mat coeffMat(1, maskChannels, CV_32F, m_maskCoeffs[idx].data());
-            m_maskMat = coeffMat * m_protoMat; 
-
-            cv::exp(-m_maskMat, m_maskMat);
-            m_maskMat = 1.0 / (1.0 + m_maskMat);
-            m_maskMat = m_maskMat.reshape(1, maskH); 
-
-            cv::resize(m_maskMat, m_maskResized, cv::Size(maskW * 4, maskH * 4)); 
-            
-            cv::Rect validRoi(info.padW, info.padH, maskW * 4 - 2 * info.padW, maskH * 4 - 2 * info.padH);
-            validRoi = validRoi & cv::Rect(0, 0, m_maskResized.cols, m_maskResized.rows);
-            if (validRoi.width > 0 && validRoi.height > 0) {
-                cv::Mat maskUnpadded = m_maskResized(validRoi);
-                cv::resize(maskUnpadded, m_maskResized, cv::Size(maskUnpadded.cols * info.scale, maskUnpadded.rows * info.scale));
+            break;
+        case YoloTask::TaskType::PoseEstimation:
+            if (rows == 4 + 1 + 3 * 17) {
+                processor = std::make_unique<CocoPosePostProcessor>(rectConfidenceThreshold, nms);
+            } else {
+                processor = std::make_unique<YoloPostProcessor<YoloTask::TaskType::PoseEstimation, 1, kDynamicCount, 0>>(rectConfidenceThreshold, nms);
+                fixedLayout = false;
             }
-
-            cv::Rect clipBox = result.box & cv::Rect(0, 0, m_maskResized.cols, m_maskResized.rows);
-            if (clipBox.width > 0 && clipBox.height > 0) {
-                cv::Mat roiMask = m_maskResized(clipBox) > 0.5f; 
-                result.boxMask = roiMask.clone();
+            break;
+        case YoloTask::TaskType::ImageSegmentation:
+            if (rows == 4 + 80 + 32) {
+                processor = std::make_unique<CocoSegmentationPostProcessor>(rectConfidenceThreshold, nms);
             } else {
-                result.boxMask = cv::Mat();
+                processor = std::make_unique<YoloPostProcessor<YoloTask::TaskType::ImageSegmentation, kDynamicCount, 0, kDynamicCount>>(rectConfidenceThreshold, nms);
+                fixedLayout = false;
             }
-
-            oResult.push_back(result);
-        }
+            break;
     }
-}
 
-void SegmentationPostProcessor::greedyNMS(float iouThresh) {
-    int n = static_cast<int>(m_confidences.size());
-    if (n == 0) return;
-    
-    m_sortIndices.resize(n);
-    std::iota(m_sortIndices.begin(), m_sortIndices.end(), 0);
-    std::sort(m_sortIndices.begin(), m_sortIndices.end(),
-              [this](int a, int b) {
-                  return m_confidences[a] > m_confidences[b];
-              });
-    
-    m_suppressed.assign(n, false);
-    
-    for (int i = 0; i < n; ++i) {
-        int idx = m_sortIndices[i];
-        if (m_suppressed[idx]) continue;    
-        
-        m_nmsIndices.push_back(idx);        
-        
-        const cv::Rect& a = m_boxes[idx];
-        float areaA = static_cast<float>(a.width * a.height);
-        
-        for (int k = i + 1; k < n; ++k) {
-            int kidx = m_sortIndices[k];
-            if (m_suppressed[kidx]) continue;
-            
-            const cv::Rect& b = m_boxes[kidx];
-            
-            int x1 = std::max(a.x, b.x);
-            int y1 = std::max(a.y, b.y);
-            int x2 = std::min(a.x + a.width,  b.x + b.width);
-            int y2 = std::min(a.y + a.height, b.y + b.height);
-            
-            if (x2 <= x1 || y2 <= y1) continue;
-            
-            float intersection = static_cast<float>((x2 - x1) * (y2 - y1));
-            float areaB = static_cast<float>(b.width * b.height);
-            float unionArea = areaA + areaB - intersection;
-            float iou = intersection / unionArea;
-            
-            if (iou > iouThresh) {
-                m_suppressed[kidx] = true;  
-            }
-        }
-    }
+    qDebug() << "[YOLO]: Output rows" << rows << (fixedLayout ? "→ COCO layout (compile-time counts)" : "→ runtime-sized layout");
+    return processor;
 }
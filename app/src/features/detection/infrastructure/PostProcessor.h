@@ -1,10 +1,12 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <memory>
 #include <vector>
 #include <string>
 #include "../domain/TaskType.h"
 #include "../domain/DetectionResult.h"
+#include "NonMaxSuppression.h"
 
 class IPostProcessor {
 public:
@@ -13,68 +15,55 @@ public:
     virtual void postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult>& oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput = nullptr, const std::vector<int64_t>& secondaryDims = {}) = 0;
 };
 
-class DetectionPostProcessor : public IPostProcessor {
-public:
-    DetectionPostProcessor(YoloTask::TaskType taskType, float rectConfidenceThreshold, float iouThreshold);
-    void initBuffers(size_t strideNum) override;
-    void postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult>& oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput = nullptr, const std::vector<int64_t>& secondaryDims = {}) override;
-private:
-    void greedyNMS(float iouThresh);
-    YoloTask::TaskType m_taskType;
-    float m_rectConfidenceThreshold;
-    float m_iouThreshold;
-    std::vector<float> m_bestScores;
-    std::vector<int> m_bestClassIds;
-    std::vector<int> m_classIds;
-    std::vector<float> m_confidences;
-    std::vector<cv::Rect> m_boxes;
-    std::vector<int> m_nmsIndices;
-    std::vector<int> m_sortIndices;
-    std::vector<bool> m_suppressed;
-};
+// A layout count that is read from the output shapes on every call
+inline constexpr int kDynamicCount = -1;
 
-class PosePostProcessor : public IPostProcessor {
+/**
+ * @brief Post-processing for every YOLOv8 head, parameterized on its layout.
+ *
+ * The output is [1, 4 + Classes + 3 * KeyPoints + MaskCoeffs, anchors]: box,
+ * class scores, then (x, y, visibility) per keypoint or mask coefficients.
+ * Fixed counts turn the per-detection decode loops into compile-time trip
+ * counts the compiler unrolls and vectorizes; kDynamicCount instantiations
+ * serve custom models. Keypoints and mask coefficients are only decoded for
+ * boxes that survive NMS.
+ */
+template <YoloTask::TaskType Task, int Classes, int KeyPoints, int MaskCoeffs>
+class YoloPostProcessor final : public IPostProcessor {
 public:
-    PosePostProcessor(YoloTask::TaskType taskType, float rectConfidenceThreshold, float iouThreshold);
+    YoloPostProcessor(float rectConfidenceThreshold, const NonMaxSuppression::Options& nms);
     void initBuffers(size_t strideNum) override;
     void postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult>& oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput = nullptr, const std::vector<int64_t>& secondaryDims = {}) override;
+
 private:
-    void greedyNMS(float iouThresh);
-    YoloTask::TaskType m_taskType;
+    static constexpr bool kPose = Task == YoloTask::TaskType::PoseEstimation;
+    static constexpr bool kSegmentation = Task == YoloTask::TaskType::ImageSegmentation;
+
+    void decodeKeyPoints(const float* rows, int strideNum, int anchor, int keyPoints,
+                         const LetterboxInfo& info, std::vector<cv::Point2f>& out) const;
+    void decodeMasks(const float* coeffRows, int strideNum, int maskCoeffs, DetectionResult* results,
+                     const LetterboxInfo& info, void* protoOutput, const std::vector<int64_t>& protoDims);
+
     float m_rectConfidenceThreshold;
-    float m_iouThreshold;
+    NonMaxSuppression m_nms;
     std::vector<float> m_bestScores;
     std::vector<int> m_bestClassIds;
+    std::vector<int> m_candidateIndices; // anchor column of each candidate
     std::vector<int> m_classIds;
     std::vector<float> m_confidences;
     std::vector<cv::Rect> m_boxes;
-    std::vector<std::vector<cv::Point2f>> m_keypoints;
     std::vector<int> m_nmsIndices;
-    std::vector<int> m_sortIndices;
-    std::vector<bool> m_suppressed;
+    std::vector<float> m_maskCoeffs;     // kept detections x MaskCoeffs
 };
 
-class SegmentationPostProcessor : public IPostProcessor {
-public:
-    SegmentationPostProcessor(YoloTask::TaskType taskType, float rectConfidenceThreshold, float iouThreshold);
-    void initBuffers(size_t strideNum) override;
-    void postProcess(void* output, const std::vector<int64_t>& outputNodeDims, std::vector<DetectionResult>& oResult, const LetterboxInfo& info, const std::vector<std::string>& classes, void* secondaryOutput = nullptr, const std::vector<int64_t>& secondaryDims = {}) override;
-private:
-    void greedyNMS(float iouThresh);
-    YoloTask::TaskType m_taskType;
-    float m_rectConfidenceThreshold;
-    float m_iouThreshold;
-    std::vector<float> m_bestScores;
-    std::vector<int> m_bestClassIds;
-    std::vector<int> m_classIds;
-    std::vector<float> m_confidences;
-    std::vector<cv::Rect> m_boxes;
-    std::vector<std::vector<float>> m_maskCoeffs;
-    std::vector<int> m_nmsIndices;
-    std::vector<int> m_sortIndices;
-    std::vector<bool> m_suppressed;
+// COCO layouts of the bundled models; anything else gets a runtime-sized instance
+using CocoDetectionPostProcessor    = YoloPostProcessor<YoloTask::TaskType::ObjectDetection, 80, 0, 0>;
+using CocoPosePostProcessor         = YoloPostProcessor<YoloTask::TaskType::PoseEstimation, 1, 17, 0>;
+using CocoSegmentationPostProcessor = YoloPostProcessor<YoloTask::TaskType::ImageSegmentation, 80, 0, 32>;
 
-    cv::Mat m_protoMat;
-    cv::Mat m_maskMat;
-    cv::Mat m_maskResized;
-};
+/**
+ * @brief Picks the instantiation matching the model's primary output shape
+ * ([1, rows, anchors]; unknown dimensions select the runtime-sized one).
+ */
+std::unique_ptr<IPostProcessor> createPostProcessor(YoloTask::TaskType task, const std::vector<int64_t>& outputShape,
+                                                    float rectConfidenceThreshold, const NonMaxSuppression::Options& nms);
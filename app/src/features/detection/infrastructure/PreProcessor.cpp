@@ -1,32 +1,212 @@
 #include "PreProcessor.h"
 #include "SimdUtils.h"
+#include "../../../shared/infrastructure/TaskScheduler.h"
+#include "../../../shared/infrastructure/Tracer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float kInv255 = 1.0f / 255.0f;
+constexpr float kPadValue = 114.0f / 255.0f; // YOLO padding color, normalized
+constexpr int kTileRows = 32;                  // output rows per scheduler task
+}
 
 ImagePreProcessor::ImagePreProcessor(YoloTask::TaskType taskType, const std::vector<int>& imgSize)
     : m_taskType(taskType), m_imgSize(imgSize) {}
 
-LetterboxInfo ImagePreProcessor::preProcess(const cv::Mat &iImg, cv::Mat &oImg) {
+void ImagePreProcessor::computeLetterbox(const cv::Size& srcSize) {
     int target_h = m_imgSize.at(0);
     int target_w = m_imgSize.at(1);
-    
-    float r = std::min(target_w / (float)iImg.cols, target_h / (float)iImg.rows);
-    int resized_w = static_cast<int>(iImg.cols * r);
-    int resized_h = static_cast<int>(iImg.rows * r);
-    
+
+    float r = std::min(target_w / (float)srcSize.width, target_h / (float)srcSize.height);
+    m_resizedW = static_cast<int>(srcSize.width * r);
+    m_resizedH = static_cast<int>(srcSize.height * r);
+
     m_info.scale = 1.0f / r;
-    m_info.padW = (target_w - resized_w) / 2;
-    m_info.padH = (target_h - resized_h) / 2;
+    m_info.padW = (target_w - m_resizedW) / 2;
+    m_info.padH = (target_h - m_resizedH) / 2;
+}
+
+const cv::Mat& ImagePreProcessor::asBgr(const cv::Mat& iImg) {
+    if (iImg.type() == CV_8UC3) return iImg;
+    if (iImg.channels() == 4) {
+        cv::cvtColor(iImg, m_bgrScratch, cv::COLOR_BGRA2BGR);
+    } else {
+        cv::cvtColor(iImg, m_bgrScratch, cv::COLOR_GRAY2BGR);
+    }
+    return m_bgrScratch;
+}
+
+LetterboxInfo ImagePreProcessor::preProcess(const cv::Mat &iImg, cv::Mat &oImg) {
+    YOLO_TRACE_SCOPE("preprocess");
+    int target_h = m_imgSize.at(0);
+    int target_w = m_imgSize.at(1);
+
+    const cv::Mat& src = asBgr(iImg);
+    computeLetterbox(src.size());
 
     if (oImg.size() != cv::Size(target_w, target_h) || oImg.type() != CV_8UC3) {
         oImg.create(target_h, target_w, CV_8UC3);
     }
-    oImg.setTo(cv::Scalar(114, 114, 114)); // YOLO padding color
+    if (oImg.data != m_paddedLetterbox || src.size() != m_paddedLetterboxSrcSize) {
+        oImg.setTo(cv::Scalar(114, 114, 114)); // YOLO padding color
+        m_paddedLetterbox = oImg.data;
+        m_paddedLetterboxSrcSize = src.size();
+    }
+
+    cv::Mat roi = oImg(cv::Rect(m_info.padW, m_info.padH, m_resizedW, m_resizedH));
+    cv::resize(src, roi, cv::Size(m_resizedW, m_resizedH));
 
-    cv::Mat roi = oImg(cv::Rect(m_info.padW, m_info.padH, resized_w, resized_h));
-    cv::resize(iImg, roi, cv::Size(resized_w, resized_h));
-    
     return m_info;
 }
 
 void ImagePreProcessor::preProcessImageToBlob(const cv::Mat& iImg, float* blob_data) {
-    simd::hwc_to_chw_bgr_to_rgb_sse41(iImg.data, blob_data, iImg.cols, iImg.rows, iImg.step);
+    YOLO_TRACE_SCOPE("preprocess.chw");
+    simd::hwc_to_chw_bgr_to_rgb(iImg.data, blob_data, iImg.cols, iImg.rows, iImg.step);
+}
+
+LetterboxInfo ImagePreProcessor::preProcessToBlob(const cv::Mat& iImg, float* blob_data) {
+    YOLO_TRACE_SCOPE("preprocess");
+    const cv::Mat* src = &asBgr(iImg);
+
+    computeLetterbox(src->size());
+    if (src->size() != m_tableSrcSize) {
+        buildResizeTables(src->size());
+    }
+
+    if (blob_data != m_paddedBlob || src->size() != m_paddedSrcSize) {
+        writePadding(blob_data);
+        m_paddedBlob = blob_data;
+        m_paddedSrcSize = src->size();
+    }
+
+    // Row tiles run on the shared scheduler, each with its own pair of cached rows
+    const size_t cachePerTile = static_cast<size_t>(2 * 3 * m_resizedW);
+    const int tiles = (m_resizedH + kTileRows - 1) / kTileRows;
+    m_rowCache.resize(cachePerTile * tiles);
+    TaskScheduler::global().parallelFor(0, m_resizedH, kTileRows, [&](int rowBegin, int rowEnd) {
+        float* rowCache = m_rowCache.data() + cachePerTile * (rowBegin / kTileRows);
+        resizeRowsToBlob(*src, blob_data, rowBegin, rowEnd, rowCache);
+    });
+
+    return m_info;
+}
+
+void ImagePreProcessor::buildResizeTables(const cv::Size& srcSize) {
+    // Same sampling grid as cv::resize(INTER_LINEAR): half-pixel centers, edge-clamped taps
+    const float scaleX = srcSize.width / (float)m_resizedW;
+    const float scaleY = srcSize.height / (float)m_resizedH;
+
+    m_xOfs0.resize(m_resizedW);
+    m_xOfs1.resize(m_resizedW);
+    m_xW0.resize(m_resizedW);
+    m_xW1.resize(m_resizedW);
+    for (int x = 0; x < m_resizedW; ++x) {
+        float fx = (x + 0.5f) * scaleX - 0.5f;
+        int sx = static_cast<int>(std::floor(fx));
+        float a = fx - sx;
+        if (sx < 0) { sx = 0; a = 0.0f; }
+        if (sx >= srcSize.width - 1) { sx = srcSize.width - 1; a = 0.0f; }
+        m_xOfs0[x] = sx * 3;
+        m_xOfs1[x] = std::min(sx + 1, srcSize.width - 1) * 3;
+        m_xW0[x] = (1.0f - a) * kInv255;
+        m_xW1[x] = a * kInv255;
+    }
+
+    m_yOfs0.resize(m_resizedH);
+    m_yOfs1.resize(m_resizedH);
+    m_yBeta.resize(m_resizedH);
+    for (int y = 0; y < m_resizedH; ++y) {
+        float fy = (y + 0.5f) * scaleY - 0.5f;
+        int sy = static_cast<int>(std::floor(fy));
+        float b = fy - sy;
+        if (sy < 0) { sy = 0; b = 0.0f; }
+        if (sy >= srcSize.height - 1) { sy = srcSize.height - 1; b = 0.0f; }
+        m_yOfs0[y] = sy;
+        m_yOfs1[y] = std::min(sy + 1, srcSize.height - 1);
+        m_yBeta[y] = b;
+    }
+
+    m_tableSrcSize = srcSize;
+}
+
+void ImagePreProcessor::writePadding(float* blob_data) const {
+    const int H = m_imgSize.at(0);
+    const int W = m_imgSize.at(1);
+    const size_t planeSize = static_cast<size_t>(H) * W;
+    const int right = m_info.padW + m_resizedW;
+    const int bottom = m_info.padH + m_resizedH;
+
+    for (int c = 0; c < 3; ++c) {
+        float* plane = blob_data + c * planeSize;
+        std::fill(plane, plane + static_cast<size_t>(m_info.padH) * W, kPadValue);
+        for (int y = m_info.padH; y < bottom; ++y) {
+            float* row = plane + static_cast<size_t>(y) * W;
+            std::fill(row, row + m_info.padW, kPadValue);
+            std::fill(row + right, row + W, kPadValue);
+        }
+        std::fill(plane + static_cast<size_t>(bottom) * W, plane + planeSize, kPadValue);
+    }
+}
+
+void ImagePreProcessor::resizeRowsToBlob(const cv::Mat& src, float* blob_data, int rowBegin, int rowEnd, float* rowCache) const {
+    const int W = m_imgSize.at(1);
+    const size_t planeSize = static_cast<size_t>(m_imgSize.at(0)) * W;
+    const int rw = m_resizedW;
+    const int* xOfs0 = m_xOfs0.data();
+    const int* xOfs1 = m_xOfs1.data();
+    const float* xW0 = m_xW0.data();
+    const float* xW1 = m_xW1.data();
+
+    // Horizontal pass: one source row -> three planar (R, G, B) rows of normalized floats
+    auto horizontal = [&](int srcRow, float* out) {
+        const uint8_t* s = src.ptr<uint8_t>(srcRow);
+        float* outR = out;
+        float* outG = out + rw;
+        float* outB = out + 2 * rw;
+        for (int x = 0; x < rw; ++x) {
+            const uint8_t* p0 = s + xOfs0[x];
+            const uint8_t* p1 = s + xOfs1[x];
+            float w0 = xW0[x];
+            float w1 = xW1[x];
+            outR[x] = p0[2] * w0 + p1[2] * w1;
+            outG[x] = p0[1] * w0 + p1[1] * w1;
+            outB[x] = p0[0] * w0 + p1[0] * w1;
+        }
+    };
+
+    // Two cached horizontal rows; on upscale consecutive output rows share source rows
+    float* rows[2] = { rowCache, rowCache + 3 * rw };
+    int cached[2] = { -1, -1 };
+
+    for (int dy = rowBegin; dy < rowEnd; ++dy) {
+        int sy0 = m_yOfs0[dy];
+        int sy1 = m_yOfs1[dy];
+        float beta = m_yBeta[dy];
+
+        if (cached[0] != sy0) {
+            if (cached[1] == sy0) {
+                std::swap(rows[0], rows[1]);
+                std::swap(cached[0], cached[1]);
+            } else {
+                horizontal(sy0, rows[0]);
+                cached[0] = sy0;
+            }
+        }
+        const float* h0 = rows[0];
+        const float* h1 = h0;
+        if (sy1 != sy0 && beta != 0.0f) {
+            if (cached[1] != sy1) {
+                horizontal(sy1, rows[1]);
+                cached[1] = sy1;
+            }
+            h1 = rows[1];
+        }
+
+        // Vertical pass straight into the planar blob
+        const size_t dstOffset = static_cast<size_t>(m_info.padH + dy) * W + m_info.padW;
+        for (int c = 0; c < 3; ++c) {
+            simd::blend_rows(h0 + c * rw, h1 + c * rw, beta, blob_data + c * planeSize + dstOffset, rw);
+        }
+    }
 }
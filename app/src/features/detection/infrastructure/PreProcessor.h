@@ -12,10 +12,41 @@ public:
     LetterboxInfo preProcess(const cv::Mat &iImg, cv::Mat &oImg);
     void preProcessImageToBlob(const cv::Mat& iImg, float* blob_data);
 
+    // Fused letterbox + bilinear resize + BGR->RGB + HWC->CHW + [0, 1] in one pass.
+    // Samples straight from the source frame into the planar float blob.
+    LetterboxInfo preProcessToBlob(const cv::Mat& iImg, float* blob_data);
+
     float getResizeScales() const { return m_info.scale; }
 
 private:
+    const cv::Mat& asBgr(const cv::Mat& iImg);
+    void computeLetterbox(const cv::Size& srcSize);
+    void buildResizeTables(const cv::Size& srcSize);
+    void writePadding(float* blob_data) const;
+    void resizeRowsToBlob(const cv::Mat& src, float* blob_data, int rowBegin, int rowEnd, float* rowCache) const;
+
     YoloTask::TaskType m_taskType;
     std::vector<int> m_imgSize;
     LetterboxInfo m_info;
+    int m_resizedW = 0;
+    int m_resizedH = 0;
+
+    // Bilinear coefficient tables, rebuilt only when the source geometry changes
+    cv::Size m_tableSrcSize;
+    std::vector<int>   m_xOfs0;   // byte offset of the left tap per output column
+    std::vector<int>   m_xOfs1;   // byte offset of the right tap (clamped)
+    std::vector<float> m_xW0;     // left/right weights, pre-scaled by 1/255
+    std::vector<float> m_xW1;
+    std::vector<int>   m_yOfs0;   // top/bottom source row per output row (clamped)
+    std::vector<int>   m_yOfs1;
+    std::vector<float> m_yBeta;   // weight of the bottom row
+    std::vector<float> m_rowCache;
+
+    // Padding is only rewritten when the geometry or the destination buffer changes
+    const float* m_paddedBlob = nullptr;
+    cv::Size m_paddedSrcSize;
+    const uchar* m_paddedLetterbox = nullptr;
+    cv::Size m_paddedLetterboxSrcSize;
+
+    cv::Mat m_bgrScratch;
 };
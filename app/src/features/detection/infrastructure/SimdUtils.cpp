@@ -0,0 +1,604 @@
+#include "SimdUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC exposes every intrinsic regardless of /arch; GCC/Clang need per-function targets
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_TARGET(isa)
+#else
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace simd {
+
+namespace {
+
+constexpr float kInv255 = 1.0f / 255.0f;
+
+inline int ctz32(uint32_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(v);
+#endif
+}
+
+inline int popcnt32(uint32_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt(v));
+#else
+    return __builtin_popcount(v);
+#endif
+}
+
+// ORs a lane mask (at most 16 lanes) into a bitset starting at bit `pos`
+inline void set_bits(uint64_t* bits, int pos, uint32_t mask) {
+    const int word = pos >> 6;
+    const int shift = pos & 63;
+    bits[word] |= static_cast<uint64_t>(mask) << shift;
+    if (shift > 48) {
+        const uint64_t spill = static_cast<uint64_t>(mask) >> (64 - shift);
+        if (spill) bits[word + 1] |= spill;
+    }
+}
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+void hwc_to_chw_scalar(const uint8_t* src, float* dst, int width, int height, int step) {
+    const int plane_size = width * height;
+    float* dst_r = dst;
+    float* dst_g = dst + plane_size;
+    float* dst_b = dst + 2 * plane_size;
+
+    for (int h = 0; h < height; ++h) {
+        const uint8_t* row_ptr = src + h * step;
+        for (int w = 0; w < width; ++w) {
+            const uint8_t* p = row_ptr + w * 3;
+            dst_r[h * width + w] = p[2] * kInv255;
+            dst_g[h * width + w] = p[1] * kInv255;
+            dst_b[h * width + w] = p[0] * kInv255;
+        }
+    }
+}
+
+void update_best_scores_scalar(const float* current_scores, float* best_scores, int* best_class_ids, int class_id, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (current_scores[i] > best_scores[i]) {
+            best_scores[i] = current_scores[i];
+            best_class_ids[i] = class_id;
+        }
+    }
+}
+
+int collect_above_threshold_scalar(const float* scores, int n, float threshold, int* out_indices) {
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        if (scores[i] > threshold) out_indices[count++] = i;
+    }
+    return count;
+}
+
+void blend_rows_scalar(const float* a, const float* b, float beta, float* dst, int n) {
+    for (int i = 0; i < n; ++i) {
+        dst[i] = a[i] + beta * (b[i] - a[i]);
+    }
+}
+
+// IoU > t is tested as intersection > t * union, so no lane divides
+void suppress_overlaps_scalar(const float* x1, const float* y1, const float* x2, const float* y2, const float* area,
+                              int begin, int end, int ref, float iou_threshold, uint64_t* suppressed) {
+    const float ax1 = x1[ref], ay1 = y1[ref], ax2 = x2[ref], ay2 = y2[ref], aarea = area[ref];
+    for (int j = begin; j < end; ++j) {
+        const float w = std::max(0.0f, std::min(ax2, x2[j]) - std::max(ax1, x1[j]));
+        const float h = std::max(0.0f, std::min(ay2, y2[j]) - std::max(ay1, y1[j]));
+        const float inter = w * h;
+        if (inter > iou_threshold * (aarea + area[j] - inter)) {
+            suppressed[j >> 6] |= uint64_t(1) << (j & 63);
+        }
+    }
+}
+
+#ifdef SIMD_X86
+
+/**
+ * @brief Splits 16 interleaved BGR pixels (48 bytes) into three 16-byte planes.
+ */
+SIMD_TARGET("ssse3")
+inline void deinterleave_bgr16(const uint8_t* p, __m128i& b, __m128i& g, __m128i& r) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)p);
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(p + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i*)(p + 32));
+
+    b = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    g = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    r = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+// ============================================================================
+// SSE4.1 (4 lanes)
+// ============================================================================
+
+// Widens the low 4 bytes to float, scales and stores
+SIMD_TARGET("sse4.1")
+inline void store4_normalized(float* out, __m128i u8, __m128 scale) {
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(u8)), scale));
+}
+
+SIMD_TARGET("sse4.1")
+void hwc_to_chw_sse41(const uint8_t* src, float* dst, int width, int height, int step) {
+    const int plane_size = width * height;
+    float* dst_r = dst;
+    float* dst_g = dst + plane_size;
+    float* dst_b = dst + 2 * plane_size;
+    const __m128 v_inv255 = _mm_set1_ps(kInv255);
+
+    for (int h = 0; h < height; ++h) {
+        const uint8_t* row_ptr = src + h * step;
+        const int o = h * width;
+        int w = 0;
+
+        for (; w <= width - 16; w += 16) {
+            __m128i b, g, r;
+            deinterleave_bgr16(row_ptr + w * 3, b, g, r);
+            for (int k = 0; k < 4; ++k) {
+                store4_normalized(dst_r + o + w + 4 * k, r, v_inv255);
+                store4_normalized(dst_g + o + w + 4 * k, g, v_inv255);
+                store4_normalized(dst_b + o + w + 4 * k, b, v_inv255);
+                r = _mm_srli_si128(r, 4);
+                g = _mm_srli_si128(g, 4);
+                b = _mm_srli_si128(b, 4);
+            }
+        }
+
+        for (; w < width; ++w) {
+            const uint8_t* p = row_ptr + w * 3;
+            dst_r[o + w] = p[2] * kInv255;
+            dst_g[o + w] = p[1] * kInv255;
+            dst_b[o + w] = p[0] * kInv255;
+        }
+    }
+}
+
+SIMD_TARGET("sse4.1")
+void update_best_scores_sse41(const float* current_scores, float* best_scores, int* best_class_ids, int class_id, int n) {
+    __m128 v_class_id = _mm_castsi128_ps(_mm_set1_epi32(class_id));
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        __m128 v_curr = _mm_loadu_ps(current_scores + i);
+        __m128 v_best = _mm_loadu_ps(best_scores + i);
+
+        __m128 v_mask = _mm_cmpgt_ps(v_curr, v_best);
+
+        _mm_storeu_ps(best_scores + i, _mm_blendv_ps(v_best, v_curr, v_mask));
+
+        __m128 v_best_ids = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(best_class_ids + i)));
+        _mm_storeu_si128((__m128i*)(best_class_ids + i), _mm_castps_si128(_mm_blendv_ps(v_best_ids, v_class_id, v_mask)));
+    }
+    update_best_scores_scalar(current_scores + i, best_scores + i, best_class_ids + i, class_id, n - i);
+}
+
+SIMD_TARGET("sse4.1")
+int collect_above_threshold_sse41(const float* scores, int n, float threshold, int* out_indices) {
+    const __m128 v_thresh = _mm_set1_ps(threshold);
+    int count = 0;
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(scores + i), v_thresh)));
+        while (mask) {
+            out_indices[count++] = i + ctz32(mask);
+            mask &= mask - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        if (scores[i] > threshold) out_indices[count++] = i;
+    }
+    return count;
+}
+
+SIMD_TARGET("sse4.1")
+void blend_rows_sse41(const float* a, const float* b, float beta, float* dst, int n) {
+    const __m128 v_beta = _mm_set1_ps(beta);
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(va, _mm_mul_ps(v_beta, _mm_sub_ps(vb, va))));
+    }
+    blend_rows_scalar(a + i, b + i, beta, dst + i, n - i);
+}
+
+SIMD_TARGET("sse4.1")
+void suppress_overlaps_sse41(const float* x1, const float* y1, const float* x2, const float* y2, const float* area,
+                             int begin, int end, int ref, float iou_threshold, uint64_t* suppressed) {
+    const __m128 ax1 = _mm_set1_ps(x1[ref]);
+    const __m128 ay1 = _mm_set1_ps(y1[ref]);
+    const __m128 ax2 = _mm_set1_ps(x2[ref]);
+    const __m128 ay2 = _mm_set1_ps(y2[ref]);
+    const __m128 aarea = _mm_set1_ps(area[ref]);
+    const __m128 v_thresh = _mm_set1_ps(iou_threshold);
+    const __m128 zero = _mm_setzero_ps();
+    int j = begin;
+    for (; j <= end - 4; j += 4) {
+        __m128 w = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(ax2, _mm_loadu_ps(x2 + j)), _mm_max_ps(ax1, _mm_loadu_ps(x1 + j))));
+        __m128 h = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(ay2, _mm_loadu_ps(y2 + j)), _mm_max_ps(ay1, _mm_loadu_ps(y1 + j))));
+        __m128 inter = _mm_mul_ps(w, h);
+        __m128 uni = _mm_sub_ps(_mm_add_ps(aarea, _mm_loadu_ps(area + j)), inter);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(inter, _mm_mul_ps(v_thresh, uni))));
+        if (mask) set_bits(suppressed, j, mask);
+    }
+    suppress_overlaps_scalar(x1, y1, x2, y2, area, j, end, ref, iou_threshold, suppressed);
+}
+
+// ============================================================================
+// AVX2 (8 lanes)
+// ============================================================================
+
+// Widens the low 8 bytes to float, scales and stores
+SIMD_TARGET("avx2,fma")
+inline void store8_normalized(float* out, __m128i u8, __m256 scale) {
+    _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8)), scale));
+}
+
+SIMD_TARGET("avx2,fma")
+void hwc_to_chw_avx2(const uint8_t* src, float* dst, int width, int height, int step) {
+    const int plane_size = width * height;
+    float* dst_r = dst;
+    float* dst_g = dst + plane_size;
+    float* dst_b = dst + 2 * plane_size;
+    const __m256 v_inv255 = _mm256_set1_ps(kInv255);
+
+    for (int h = 0; h < height; ++h) {
+        const uint8_t* row_ptr = src + h * step;
+        const int o = h * width;
+        int w = 0;
+
+        for (; w <= width - 16; w += 16) {
+            __m128i b, g, r;
+            deinterleave_bgr16(row_ptr + w * 3, b, g, r);
+            store8_normalized(dst_r + o + w, r, v_inv255);
+            store8_normalized(dst_g + o + w, g, v_inv255);
+            store8_normalized(dst_b + o + w, b, v_inv255);
+            store8_normalized(dst_r + o + w + 8, _mm_srli_si128(r, 8), v_inv255);
+            store8_normalized(dst_g + o + w + 8, _mm_srli_si128(g, 8), v_inv255);
+            store8_normalized(dst_b + o + w + 8, _mm_srli_si128(b, 8), v_inv255);
+        }
+
+        for (; w < width; ++w) {
+            const uint8_t* p = row_ptr + w * 3;
+            dst_r[o + w] = p[2] * kInv255;
+            dst_g[o + w] = p[1] * kInv255;
+            dst_b[o + w] = p[0] * kInv255;
+        }
+    }
+}
+
+SIMD_TARGET("avx2,fma")
+void update_best_scores_avx2(const float* current_scores, float* best_scores, int* best_class_ids, int class_id, int n) {
+    const __m256 v_class_id = _mm256_castsi256_ps(_mm256_set1_epi32(class_id));
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 v_curr = _mm256_loadu_ps(current_scores + i);
+        __m256 v_best = _mm256_loadu_ps(best_scores + i);
+        __m256 v_mask = _mm256_cmp_ps(v_curr, v_best, _CMP_GT_OQ);
+
+        _mm256_storeu_ps(best_scores + i, _mm256_blendv_ps(v_best, v_curr, v_mask));
+
+        __m256 v_best_ids = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)(best_class_ids + i)));
+        _mm256_storeu_si256((__m256i*)(best_class_ids + i), _mm256_castps_si256(_mm256_blendv_ps(v_best_ids, v_class_id, v_mask)));
+    }
+    update_best_scores_scalar(current_scores + i, best_scores + i, best_class_ids + i, class_id, n - i);
+}
+
+SIMD_TARGET("avx2,fma")
+int collect_above_threshold_avx2(const float* scores, int n, float threshold, int* out_indices) {
+    const __m256 v_thresh = _mm256_set1_ps(threshold);
+    int count = 0;
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(scores + i), v_thresh, _CMP_GT_OQ)));
+        while (mask) {
+            out_indices[count++] = i + ctz32(mask);
+            mask &= mask - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        if (scores[i] > threshold) out_indices[count++] = i;
+    }
+    return count;
+}
+
+SIMD_TARGET("avx2,fma")
+void blend_rows_avx2(const float* a, const float* b, float beta, float* dst, int n) {
+    const __m256 v_beta = _mm256_set1_ps(beta);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(v_beta, _mm256_sub_ps(vb, va), va));
+    }
+    blend_rows_scalar(a + i, b + i, beta, dst + i, n - i);
+}
+
+SIMD_TARGET("avx2,fma")
+void suppress_overlaps_avx2(const float* x1, const float* y1, const float* x2, const float* y2, const float* area,
+                            int begin, int end, int ref, float iou_threshold, uint64_t* suppressed) {
+    const __m256 ax1 = _mm256_set1_ps(x1[ref]);
+    const __m256 ay1 = _mm256_set1_ps(y1[ref]);
+    const __m256 ax2 = _mm256_set1_ps(x2[ref]);
+    const __m256 ay2 = _mm256_set1_ps(y2[ref]);
+    const __m256 aarea = _mm256_set1_ps(area[ref]);
+    const __m256 v_thresh = _mm256_set1_ps(iou_threshold);
+    const __m256 zero = _mm256_setzero_ps();
+    int j = begin;
+    for (; j <= end - 8; j += 8) {
+        __m256 w = _mm256_max_ps(zero, _mm256_sub_ps(_mm256_min_ps(ax2, _mm256_loadu_ps(x2 + j)), _mm256_max_ps(ax1, _mm256_loadu_ps(x1 + j))));
+        __m256 h = _mm256_max_ps(zero, _mm256_sub_ps(_mm256_min_ps(ay2, _mm256_loadu_ps(y2 + j)), _mm256_max_ps(ay1, _mm256_loadu_ps(y1 + j))));
+        __m256 inter = _mm256_mul_ps(w, h);
+        __m256 uni = _mm256_sub_ps(_mm256_add_ps(aarea, _mm256_loadu_ps(area + j)), inter);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(inter, _mm256_mul_ps(v_thresh, uni), _CMP_GT_OQ)));
+        if (mask) set_bits(suppressed, j, mask);
+    }
+    // Called once per kept box: clear the upper halves before the non-VEX tail,
+    // or every call pays an AVX/SSE transition
+    _mm256_zeroupper();
+    suppress_overlaps_scalar(x1, y1, x2, y2, area, j, end, ref, iou_threshold, suppressed);
+}
+
+// ============================================================================
+// AVX-512 (16 lanes)
+// ============================================================================
+
+SIMD_TARGET("avx512f")
+void hwc_to_chw_avx512(const uint8_t* src, float* dst, int width, int height, int step) {
+    const int plane_size = width * height;
+    float* dst_r = dst;
+    float* dst_g = dst + plane_size;
+    float* dst_b = dst + 2 * plane_size;
+    const __m512 v_inv255 = _mm512_set1_ps(kInv255);
+
+    for (int h = 0; h < height; ++h) {
+        const uint8_t* row_ptr = src + h * step;
+        const int o = h * width;
+        int w = 0;
+
+        for (; w <= width - 16; w += 16) {
+            __m128i b, g, r;
+            deinterleave_bgr16(row_ptr + w * 3, b, g, r);
+            _mm512_storeu_ps(dst_r + o + w, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(r)), v_inv255));
+            _mm512_storeu_ps(dst_g + o + w, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(g)), v_inv255));
+            _mm512_storeu_ps(dst_b + o + w, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(b)), v_inv255));
+        }
+
+        for (; w < width; ++w) {
+            const uint8_t* p = row_ptr + w * 3;
+            dst_r[o + w] = p[2] * kInv255;
+            dst_g[o + w] = p[1] * kInv255;
+            dst_b[o + w] = p[0] * kInv255;
+        }
+    }
+}
+
+SIMD_TARGET("avx512f")
+void update_best_scores_avx512(const float* current_scores, float* best_scores, int* best_class_ids, int class_id, int n) {
+    const __m512i v_class_id = _mm512_set1_epi32(class_id);
+    int i = 0;
+    for (; i <= n - 16; i += 16) {
+        __m512 v_curr = _mm512_loadu_ps(current_scores + i);
+        __m512 v_best = _mm512_loadu_ps(best_scores + i);
+        __mmask16 m = _mm512_cmp_ps_mask(v_curr, v_best, _CMP_GT_OQ);
+
+        _mm512_mask_storeu_ps(best_scores + i, m, v_curr);
+        _mm512_mask_storeu_epi32(best_class_ids + i, m, v_class_id);
+    }
+    update_best_scores_scalar(current_scores + i, best_scores + i, best_class_ids + i, class_id, n - i);
+}
+
+SIMD_TARGET("avx512f")
+int collect_above_threshold_avx512(const float* scores, int n, float threshold, int* out_indices) {
+    const __m512 v_thresh = _mm512_set1_ps(threshold);
+    const __m512i v_step = _mm512_set1_epi32(16);
+    __m512i v_idx = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    int count = 0;
+    int i = 0;
+    for (; i <= n - 16; i += 16) {
+        __mmask16 m = _mm512_cmp_ps_mask(_mm512_loadu_ps(scores + i), v_thresh, _CMP_GT_OQ);
+        if (m) {
+            // Compress the passing lane indices into a dense run, no per-bit loop
+            _mm512_mask_compressstoreu_epi32(out_indices + count, m, v_idx);
+            count += popcnt32(m);
+        }
+        v_idx = _mm512_add_epi32(v_idx, v_step);
+    }
+    for (; i < n; ++i) {
+        if (scores[i] > threshold) out_indices[count++] = i;
+    }
+    return count;
+}
+
+SIMD_TARGET("avx512f")
+void blend_rows_avx512(const float* a, const float* b, float beta, float* dst, int n) {
+    const __m512 v_beta = _mm512_set1_ps(beta);
+    int i = 0;
+    for (; i <= n - 16; i += 16) {
+        __m512 va = _mm512_loadu_ps(a + i);
+        __m512 vb = _mm512_loadu_ps(b + i);
+        _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(v_beta, _mm512_sub_ps(vb, va), va));
+    }
+    blend_rows_scalar(a + i, b + i, beta, dst + i, n - i);
+}
+
+SIMD_TARGET("avx512f")
+void suppress_overlaps_avx512(const float* x1, const float* y1, const float* x2, const float* y2, const float* area,
+                              int begin, int end, int ref, float iou_threshold, uint64_t* suppressed) {
+    const __m512 ax1 = _mm512_set1_ps(x1[ref]);
+    const __m512 ay1 = _mm512_set1_ps(y1[ref]);
+    const __m512 ax2 = _mm512_set1_ps(x2[ref]);
+    const __m512 ay2 = _mm512_set1_ps(y2[ref]);
+    const __m512 aarea = _mm512_set1_ps(area[ref]);
+    const __m512 v_thresh = _mm512_set1_ps(iou_threshold);
+    const __m512 zero = _mm512_setzero_ps();
+    int j = begin;
+    for (; j <= end - 16; j += 16) {
+        __m512 w = _mm512_max_ps(zero, _mm512_sub_ps(_mm512_min_ps(ax2, _mm512_loadu_ps(x2 + j)), _mm512_max_ps(ax1, _mm512_loadu_ps(x1 + j))));
+        __m512 h = _mm512_max_ps(zero, _mm512_sub_ps(_mm512_min_ps(ay2, _mm512_loadu_ps(y2 + j)), _mm512_max_ps(ay1, _mm512_loadu_ps(y1 + j))));
+        __m512 inter = _mm512_mul_ps(w, h);
+        __m512 uni = _mm512_sub_ps(_mm512_add_ps(aarea, _mm512_loadu_ps(area + j)), inter);
+        __mmask16 m = _mm512_cmp_ps_mask(inter, _mm512_mul_ps(v_thresh, uni), _CMP_GT_OQ);
+        if (m) set_bits(suppressed, j, static_cast<uint32_t>(m));
+    }
+    _mm256_zeroupper();
+    suppress_overlaps_scalar(x1, y1, x2, y2, area, j, end, ref, iou_threshold, suppressed);
+}
+
+// ============================================================================
+// CPUID
+// ============================================================================
+
+void cpuid(int out[4], int leaf, int subleaf) {
+#if defined(_MSC_VER)
+    __cpuidex(out, leaf, subleaf);
+#else
+    unsigned int a, b, c, d;
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+    out[0] = (int)a; out[1] = (int)b; out[2] = (int)c; out[3] = (int)d;
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+#endif // SIMD_X86
+
+Isa parseIsaCap(const char* env) {
+    if (!env || !*env) return Isa::AVX512;
+    // Case and separators are ignored, so isaName() output ("SSE4.1", "AVX-512") works too
+    std::string v;
+    for (const char* c = env; *c; ++c) {
+        if (*c == '-' || *c == '.' || *c == '_') continue;
+        v += static_cast<char>(std::tolower(static_cast<unsigned char>(*c)));
+    }
+    if (v == "scalar") return Isa::Scalar;
+    if (v == "sse41")  return Isa::SSE41;
+    if (v == "avx2")   return Isa::AVX2;
+    if (v == "avx512") return Isa::AVX512;
+    std::cerr << "[SIMD]: Ignoring unknown YOLO_SIMD_ISA=" << env
+              << " (expected scalar, sse41, avx2 or avx512)" << std::endl;
+    return Isa::AVX512;
+}
+
+Isa isaCapFromEnv() {
+    static const Isa cap = parseIsaCap(std::getenv("YOLO_SIMD_ISA")); // warns once
+    return cap;
+}
+
+Kernels makeKernels(Isa isa) {
+    Kernels k{Isa::Scalar, hwc_to_chw_scalar, update_best_scores_scalar, collect_above_threshold_scalar, blend_rows_scalar,
+             suppress_overlaps_scalar};
+#ifdef SIMD_X86
+    switch (isa) {
+        case Isa::AVX512:
+            k = {Isa::AVX512, hwc_to_chw_avx512, update_best_scores_avx512, collect_above_threshold_avx512, blend_rows_avx512,
+                 suppress_overlaps_avx512};
+            break;
+        case Isa::AVX2:
+            k = {Isa::AVX2, hwc_to_chw_avx2, update_best_scores_avx2, collect_above_threshold_avx2, blend_rows_avx2,
+                 suppress_overlaps_avx2};
+            break;
+        case Isa::SSE41:
+            k = {Isa::SSE41, hwc_to_chw_sse41, update_best_scores_sse41, collect_above_threshold_sse41, blend_rows_sse41,
+                 suppress_overlaps_sse41};
+            break;
+        case Isa::Scalar:
+            break;
+    }
+#else
+    (void)isa;
+#endif
+    return k;
+}
+
+} // namespace
+
+Isa detectIsa() {
+    Isa best = Isa::Scalar;
+#ifdef SIMD_X86
+    int r[4];
+    cpuid(r, 0, 0);
+    const int maxLeaf = r[0];
+
+    cpuid(r, 1, 0);
+    const bool ssse3   = (r[2] & (1 << 9))  != 0;
+    const bool sse41   = (r[2] & (1 << 19)) != 0;
+    const bool fma     = (r[2] & (1 << 12)) != 0;
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const bool avx     = (r[2] & (1 << 28)) != 0;
+
+    if (ssse3 && sse41) best = Isa::SSE41;
+
+    if (maxLeaf >= 7 && osxsave && avx) {
+        const uint64_t xcr0 = xgetbv0();
+        const bool osAvx    = (xcr0 & 0x6) == 0x6;    // XMM + YMM state
+        const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;  // + opmask, ZMM_Hi256, Hi16_ZMM
+
+        cpuid(r, 7, 0);
+        const bool avx2    = (r[1] & (1 << 5))  != 0;
+        const bool avx512f = (r[1] & (1 << 16)) != 0;
+
+        if (osAvx && avx2 && fma) best = Isa::AVX2;
+        if (best == Isa::AVX2 && osAvx512 && avx512f) best = Isa::AVX512;
+    }
+#endif
+    Isa cap = isaCapFromEnv();
+    return static_cast<int>(best) < static_cast<int>(cap) ? best : cap;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX512: return "AVX-512";
+        case Isa::AVX2:   return "AVX2";
+        case Isa::SSE41:  return "SSE4.1";
+        case Isa::Scalar: return "Scalar";
+    }
+    return "Unknown";
+}
+
+const Kernels& kernels() {
+    static const Kernels table = makeKernels(detectIsa());
+    return table;
+}
+
+} // namespace simd
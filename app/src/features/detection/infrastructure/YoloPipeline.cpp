@@ -3,15 +3,19 @@
 #include <chrono>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include "backends/OnnxRuntimeBackend.h"
 #include "backends/OpenVinoBackend.h"
+#include "../../../shared/infrastructure/PerfCounters.h"
 #include <QDebug>
 
 YoloPipeline::YoloPipeline() {}
 
 YoloPipeline::~YoloPipeline() {}
 
-const char* YoloPipeline::createSession(const InferenceConfig& config) {
+const char* YoloPipeline::createSession(const InferenceConfig& config, const LoadProgress& progress) {
+    auto report = [&progress](float fraction) { return !progress || progress(fraction); };
+
     std::regex pattern("[\u4e00-\u9fa5]");
     if (std::regex_search(config.modelPath, pattern)) {
         return "[YoloPipeline]: Model path cannot contain Chinese characters.";
@@ -33,21 +37,8 @@ const char* YoloPipeline::createSession(const InferenceConfig& config) {
             qDebug() << "[YoloPipeline]: Warning: Could not open assets/classes.txt. Class names will be empty.";
         }
 
-        m_preProcessor = std::make_unique<ImagePreProcessor>(m_taskType, m_imgSize);
-
-        switch (m_taskType) {
-            case YoloTask::TaskType::ObjectDetection:
-                m_postProcessor = std::make_unique<DetectionPostProcessor>(m_taskType, config.confidenceThreshold, config.iouThreshold);
-                break;
-            case YoloTask::TaskType::PoseEstimation:
-                m_postProcessor = std::make_unique<PosePostProcessor>(m_taskType, config.confidenceThreshold, config.iouThreshold);
-                break;
-            case YoloTask::TaskType::ImageSegmentation:
-                m_postProcessor = std::make_unique<SegmentationPostProcessor>(m_taskType, config.confidenceThreshold, config.iouThreshold);
-                break;
-            default:
-                throw std::runtime_error("Unsupported task type.");
-        }
+        if (m_backend) m_backend->waitForPending();
+        if (!report(0.05f)) return kLoadCancelled;
 
         if (config.runtimeType == YoloTask::RuntimeType::ONNXRuntime) {
             m_backend = std::make_unique<OnnxRuntimeBackend>();
@@ -57,15 +48,25 @@ const char* YoloPipeline::createSession(const InferenceConfig& config) {
 
         const char* backendStatus = m_backend->createSession(config);
         if (backendStatus != nullptr) return backendStatus;
-
-        std::vector<int64_t> outShape = m_backend->getOutputShape();
-        if (!outShape.empty() && outShape.size() >= 3) {
-            m_postProcessor->initBuffers(static_cast<size_t>(outShape[2]));
-        } else {
-            m_postProcessor->initBuffers(8400); 
+        if (!report(0.8f)) return kLoadCancelled;
+        qDebug() << "[YoloPipeline]: Backend input"
+                 << (m_backend->inputFormat() == InputFormat::InterleavedU8 ? "u8 NHWC (preprocessing in graph)" : "f32 NCHW");
+
+        m_slots.clear();
+        m_slots.resize(static_cast<size_t>(m_backend->slotCount()));
+        for (InferenceSlot& slot : m_slots) {
+            slot.preProcessor = std::make_unique<ImagePreProcessor>(m_taskType, m_imgSize);
         }
+        qDebug() << "[YoloPipeline]: Request slots" << m_slots.size();
+
+        // Chosen from the output layout, so it comes after the backend session
+        if (const char* status = configurePostProcessing(config)) return status;
+
+        m_footprintBytes = estimateFootprint(config);
+        if (!report(0.85f)) return kLoadCancelled;
 
         warmUp();
+        report(1.0f);
         return nullptr; // OK
     } catch (const std::exception &e) {
         std::cerr << "[YoloPipeline]: " << e.what() << std::endl;
@@ -73,41 +74,176 @@ const char* YoloPipeline::createSession(const InferenceConfig& config) {
     }
 }
 
-char* YoloPipeline::runInference(const cv::Mat& frame,
-                                 std::vector<DetectionResult>& results,
-                                 InferenceTiming& timing) {
-    auto start_pre = std::chrono::high_resolution_clock::now();
-
-    LetterboxInfo info = m_preProcessor->preProcess(frame, m_letterboxBuffer);
+const char* YoloPipeline::configurePostProcessing(const InferenceConfig& config) {
+    if (!m_backend) return "[YoloPipeline]: No session to configure.";
+
+    NonMaxSuppression::Options nms;
+    nms.mode = config.nmsMode;
+    nms.classAgnostic = config.classAgnosticNms;
+    nms.iouThreshold = config.iouThreshold;
+    nms.maxCandidates = config.maxCandidates;
+    nms.maxDetections = config.maxDetections;
+
+    std::vector<int64_t> outShape = m_backend->getOutputShape();
+    std::unique_ptr<IPostProcessor> postProcessor = createPostProcessor(m_taskType, outShape, config.confidenceThreshold, nms);
+    if (!postProcessor) return "[YoloPipeline]: Unsupported task type.";
+    if (!outShape.empty() && outShape.size() >= 3 && outShape[2] > 0) {
+        postProcessor->initBuffers(static_cast<size_t>(outShape[2]));
+    } else {
+        postProcessor->initBuffers(8400); 
+    }
+    m_postProcessor = std::move(postProcessor);
+    return nullptr;
+}
 
+LetterboxInfo YoloPipeline::preProcessInto(int slot, const cv::Mat& frame) {
     int height = m_imgSize.at(0);
     int width = m_imgSize.at(1);
-    
-    int sz[] = {1, 3, height, width};
-    m_commonBlob.create(4, sz, CV_32F);
-    float* blob_data = m_commonBlob.ptr<float>();
-    m_preProcessor->preProcessImageToBlob(m_letterboxBuffer, blob_data);
 
-    std::vector<int64_t> inputNodeDims = {1, 3, (int64_t)height, (int64_t)width};
+    // Preprocess straight into the backend-owned input tensor
+    ImagePreProcessor& preProcessor = *m_slots[slot].preProcessor;
+    void* input = m_backend->inputBuffer(slot);
+    if (m_backend->inputFormat() == InputFormat::InterleavedU8) {
+        // The graph converts u8 BGR NHWC itself; only the letterbox is done here
+        cv::Mat letterbox(height, width, CV_8UC3, input);
+        return preProcessor.preProcess(frame, letterbox);
+    }
+    return preProcessor.preProcessToBlob(frame, static_cast<float*>(input));
+}
+
+char* YoloPipeline::runInference(const cv::Mat& frame,
+                                 std::vector<DetectionResult>& results,
+                                 InferenceTiming& timing) {
+    PerfCounters& counters = PerfCounters::instance();
+
+    HardwareCounters counters_pre = counters.readCurrentThread();
+    auto start_pre = std::chrono::high_resolution_clock::now();
+    LetterboxInfo info = preProcessInto(0, frame);
     auto end_pre = std::chrono::high_resolution_clock::now();
     timing.preProcess = std::chrono::duration<double, std::milli>(end_pre - start_pre).count();
 
+    // Runtime pools plus this thread, which takes part in a synchronous run
+    HardwareCounters counters_infer = counters.readCurrentThread();
+    HardwareCounters counters_runtime = counters.readRuntimeThreads();
+    timing.preCounters = counters_infer - counters_pre;
     auto start_infer = std::chrono::high_resolution_clock::now();
-    InferenceOutput out = m_backend->runInference(blob_data, inputNodeDims);
+    InferenceOutput out = m_backend->runInference(0);
     auto end_infer = std::chrono::high_resolution_clock::now();
     timing.inference = std::chrono::duration<double, std::milli>(end_infer - start_infer).count();
 
+    HardwareCounters counters_post = counters.readCurrentThread();
+    timing.inferCounters = (counters_post - counters_infer) + (counters.readRuntimeThreads() - counters_runtime);
     auto start_post = std::chrono::high_resolution_clock::now();
     m_postProcessor->postProcess(out.primaryData, out.primaryShape, results, 
                                  info, m_classes, 
                                  out.secondaryData, out.secondaryShape);
     auto end_post = std::chrono::high_resolution_clock::now();
     timing.postProcess = std::chrono::duration<double, std::milli>(end_post - start_post).count();
+    timing.postCounters = counters.readCurrentThread() - counters_post;
     
     timing.total = timing.preProcess + timing.inference + timing.postProcess;
     return nullptr; // OK
 }
 
+int YoloPipeline::submitInference(const cv::Mat& frame, std::function<void(int slot)> onInferred) {
+    int slotIndex = -1;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (!m_slots[i].busy) {
+            slotIndex = static_cast<int>(i);
+            break;
+        }
+    }
+    if (slotIndex < 0) return -1;
+
+    prepareInference(slotIndex, frame);
+    startPrepared(slotIndex, std::move(onInferred));
+    return slotIndex;
+}
+
+void YoloPipeline::prepareInference(int slotIndex, const cv::Mat& frame) {
+    InferenceSlot& slot = m_slots.at(slotIndex);
+    slot.busy = true;
+    HardwareCounters counters_pre = PerfCounters::instance().readCurrentThread();
+    auto start_pre = std::chrono::high_resolution_clock::now();
+    slot.info = preProcessInto(slotIndex, frame);
+    auto end_pre = std::chrono::high_resolution_clock::now();
+    slot.preProcessMs = std::chrono::duration<double, std::milli>(end_pre - start_pre).count();
+    slot.preCounters = PerfCounters::instance().readCurrentThread() - counters_pre;
+}
+
+void YoloPipeline::startPrepared(int slotIndex, std::function<void(int slot)> onInferred) {
+    InferenceSlot& slot = m_slots.at(slotIndex);
+    slot.error = nullptr;
+    slot.inferStartCounters = PerfCounters::instance().readRuntimeThreads();
+    slot.inferStart = std::chrono::high_resolution_clock::now();
+    m_backend->startInference(slotIndex, [this, onInferred](int done, const char* error) {
+        InferenceSlot& finished = m_slots[done];
+        finished.inferEnd = std::chrono::high_resolution_clock::now();
+        finished.inferCounters = PerfCounters::instance().readRuntimeThreads() - finished.inferStartCounters;
+        finished.error = error;
+        onInferred(done);
+    });
+}
+
+void YoloPipeline::releaseInference(int slotIndex) {
+    m_slots.at(slotIndex).busy = false;
+}
+
+const char* YoloPipeline::completeInference(int slotIndex,
+                                            std::vector<DetectionResult>& results,
+                                            InferenceTiming& timing) {
+    InferenceSlot& slot = m_slots.at(slotIndex);
+    timing.preProcess = slot.preProcessMs;
+    timing.inference = std::chrono::duration<double, std::milli>(slot.inferEnd - slot.inferStart).count();
+    timing.preCounters = slot.preCounters;
+    timing.inferCounters = slot.inferCounters;
+
+    if (slot.error != nullptr) {
+        slot.busy = false;
+        timing.postProcess = 0.0;
+        timing.total = timing.preProcess + timing.inference;
+        return slot.error;
+    }
+
+    HardwareCounters counters_post = PerfCounters::instance().readCurrentThread();
+    auto start_post = std::chrono::high_resolution_clock::now();
+    InferenceOutput out = m_backend->outputs(slotIndex);
+    m_postProcessor->postProcess(out.primaryData, out.primaryShape, results,
+                                 slot.info, m_classes,
+                                 out.secondaryData, out.secondaryShape);
+    auto end_post = std::chrono::high_resolution_clock::now();
+    timing.postProcess = std::chrono::duration<double, std::milli>(end_post - start_post).count();
+    timing.postCounters = PerfCounters::instance().readCurrentThread() - counters_post;
+
+    // Outputs have been consumed, the slot can take the next frame
+    slot.busy = false;
+
+    timing.total = timing.preProcess + timing.inference + timing.postProcess;
+    return nullptr; // OK
+}
+
+void YoloPipeline::waitForPending() {
+    if (m_backend) m_backend->waitForPending();
+}
+
+size_t YoloPipeline::estimateFootprint(const InferenceConfig& config) const {
+    // Weights are held once by the runtime plus working copies during execution
+    std::error_code ec;
+    std::filesystem::path modelFile(config.modelPath);
+    uintmax_t weights = std::filesystem::file_size(modelFile, ec);
+    if (ec) weights = 0;
+    if (modelFile.extension() == ".xml") {
+        uintmax_t bin = std::filesystem::file_size(std::filesystem::path(modelFile).replace_extension(".bin"), ec);
+        if (!ec) weights += bin;
+    }
+
+    size_t inputBytes = static_cast<size_t>(m_imgSize.at(0)) * m_imgSize.at(1) * 3 * sizeof(float);
+    size_t outputBytes = sizeof(float);
+    for (int64_t d : m_backend->getOutputShape()) outputBytes *= static_cast<size_t>(d > 0 ? d : 1);
+
+    return static_cast<size_t>(weights) * 2 + m_slots.size() * (inputBytes + outputBytes);
+}
+
 void YoloPipeline::warmUp() {
     if (m_backend) {
         m_backend->warmUp(m_imgSize);
@@ -3,6 +3,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <chrono>
 #include <opencv2/opencv.hpp>
 #include "../domain/IDetectionModel.h"
 #include "PreProcessor.h"
@@ -14,23 +15,49 @@ public:
     YoloPipeline();
     ~YoloPipeline() override;
 
-    const char* createSession(const InferenceConfig& config) override;
+    const char* createSession(const InferenceConfig& config, const LoadProgress& progress = {}) override;
+    const char* configurePostProcessing(const InferenceConfig& config) override;
     char* runInference(const cv::Mat& frame,
                        std::vector<DetectionResult>& results,
                        InferenceTiming& timing) override;
+    int maxInFlight() const override { return static_cast<int>(m_slots.size()); }
+    int submitInference(const cv::Mat& frame, std::function<void(int slot)> onInferred) override;
+    const char* completeInference(int slot,
+                                  std::vector<DetectionResult>& results,
+                                  InferenceTiming& timing) override;
+    void waitForPending() override;
+    void prepareInference(int slot, const cv::Mat& frame) override;
+    void startPrepared(int slot, std::function<void(int slot)> onInferred) override;
+    void releaseInference(int slot) override;
+    size_t memoryFootprint() const override { return m_footprintBytes; }
     const std::vector<std::string>& classNames() const override { return m_classes; }
     void warmUp() override;
 
 private:
+    // One per backend request slot. Each slot has its own preprocessor so the
+    // padding cache follows that slot's input buffer.
+    struct InferenceSlot {
+        std::unique_ptr<ImagePreProcessor> preProcessor;
+        LetterboxInfo info;
+        double preProcessMs = 0.0;
+        std::chrono::high_resolution_clock::time_point inferStart;
+        std::chrono::high_resolution_clock::time_point inferEnd; // written by the runtime callback
+        HardwareCounters preCounters;
+        HardwareCounters inferStartCounters;
+        HardwareCounters inferCounters;                         // written by the runtime callback
+        const char* error = nullptr;
+        bool busy = false;
+    };
+
+    LetterboxInfo preProcessInto(int slot, const cv::Mat& frame);
+    size_t estimateFootprint(const InferenceConfig& config) const;
+
     std::unique_ptr<IInferenceBackend> m_backend;
-    std::unique_ptr<ImagePreProcessor> m_preProcessor;
+    std::vector<InferenceSlot> m_slots;
     std::unique_ptr<IPostProcessor> m_postProcessor;
 
     YoloTask::TaskType m_taskType;
     std::vector<int> m_imgSize;
     std::vector<std::string> m_classes;
-
-    // Optimization: Reusable memory for blob to avoid reallocations
-    cv::Mat m_commonBlob; 
-    cv::Mat m_letterboxBuffer;
+    size_t m_footprintBytes = 0;
 };
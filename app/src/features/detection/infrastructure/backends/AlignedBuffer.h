@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/**
+ * @brief Zero-initialized heap block aligned to a cache line (and an AVX-512 vector).
+ *
+ * Used for tensors the backends own for the lifetime of a session, so the
+ * per-frame path never allocates. Move-only.
+ */
+class AlignedBuffer {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(size_t bytes) { allocate(bytes); }
+    ~AlignedBuffer() { release(); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept : m_data(other.m_data), m_size(other.m_size) {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    void allocate(size_t bytes) {
+        release();
+        if (bytes == 0) return;
+        size_t rounded = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+#ifdef _WIN32
+        m_data = _aligned_malloc(rounded, kAlignment);
+#else
+        m_data = std::aligned_alloc(kAlignment, rounded);
+#endif
+        if (!m_data) throw std::bad_alloc();
+        std::memset(m_data, 0, rounded);
+        m_size = bytes;
+    }
+
+    void release() {
+        if (m_data) {
+#ifdef _WIN32
+            _aligned_free(m_data);
+#else
+            std::free(m_data);
+#endif
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    void* data() const { return m_data; }
+    template <typename T> T* as() const { return static_cast<T*>(m_data); }
+    size_t size() const { return m_size; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+};
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <functional>
 #include "../domain/InferenceConfig.h"
 
 struct InferenceOutput {
@@ -11,13 +12,47 @@ struct InferenceOutput {
     std::vector<int64_t> secondaryShape;
 };
 
+// Layout the backend expects in the buffer passed to runInference()
+enum class InputFormat {
+    PlanarF32,     // NCHW float32, RGB, normalized to [0, 1]
+    InterleavedU8  // NHWC uint8, BGR as captured; conversion happens inside the model
+};
+
+// Called once a slot's outputs are ready; error is nullptr on success.
+// May run on a runtime-owned thread.
+using InferenceCallback = std::function<void(int slot, const char* error)>;
+
 class IInferenceBackend {
 public:
     virtual ~IInferenceBackend() = default;
 
     virtual const char* createSession(const InferenceConfig& config) = 0;
-    
-    virtual InferenceOutput runInference(float* blobData, const std::vector<int64_t>& inputDims) = 0;
+
+    // Number of independent request slots (in-flight inferences) the session supports.
+    virtual int slotCount() const { return 1; }
+
+    // Preallocated input owned by the backend, laid out per inputFormat().
+    // Fill it in place, then call runInference(). Stable until the next createSession().
+    virtual void* inputBuffer(int slot = 0) = 0;
+
+    // Blocking inference on a slot.
+    virtual InferenceOutput runInference(int slot = 0) = 0;
+
+    // Starts inference on a slot without blocking. The slot's input and outputs
+    // must not be touched until onDone has been called for it.
+    virtual void startInference(int slot, InferenceCallback onDone) {
+        runInference(slot);
+        onDone(slot, nullptr);
+    }
+
+    // Outputs of the last completed inference on a slot, valid until it is reused.
+    virtual InferenceOutput outputs(int slot) = 0;
+
+    // Blocks until no slot has an inference in flight. Never throws (it runs in
+    // destructors); a failed inference was already reported to its callback.
+    virtual void waitForPending() {}
+
+    virtual InputFormat inputFormat() const { return InputFormat::PlanarF32; }
     
     virtual void warmUp(const std::vector<int>& imgSize) = 0;
     
@@ -0,0 +1,153 @@
+#include "ModelCache.h"
+#include "../../../../shared/domain/AppConfig.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <iomanip>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime  = 1099511628211ull;
+
+void hashBytes(uint64_t& h, const char* data, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= kFnvPrime;
+    }
+}
+
+void hashString(uint64_t& h, const std::string& s) {
+    hashBytes(h, s.data(), s.size());
+    hashBytes(h, "\0", 1); // field separator
+}
+
+bool hashContents(uint64_t& h, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::vector<char> chunk(1 << 16);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hashBytes(h, chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+    return true;
+}
+
+// Content hashes of model files, reused while the size and mtime are unchanged
+// so repeated session creation does not re-read the whole model
+struct FileDigest {
+    uintmax_t size = 0;
+    fs::file_time_type mtime;
+    uint64_t hash = 0;
+};
+
+bool hashFile(uint64_t& h, const std::string& path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, FileDigest> digests;
+
+    std::error_code ec;
+    const uintmax_t size = fs::file_size(path, ec);
+    if (ec) return false;
+    const fs::file_time_type mtime = fs::last_write_time(path, ec);
+    if (ec) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = digests.find(path);
+        if (it != digests.end() && it->second.size == size && it->second.mtime == mtime) {
+            hashBytes(h, reinterpret_cast<const char*>(&it->second.hash), sizeof(uint64_t));
+            return true;
+        }
+    }
+
+    FileDigest digest;
+    digest.size = size;
+    digest.mtime = mtime;
+    digest.hash = kFnvOffset;
+    if (!hashContents(digest.hash, path)) return false;
+    hashBytes(h, reinterpret_cast<const char*>(&digest.hash), sizeof(uint64_t));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    digests[path] = digest;
+    return true;
+}
+
+} // namespace
+
+namespace ModelCache {
+
+std::string key(const InferenceConfig& config, const std::string& device) {
+    uint64_t h = kFnvOffset;
+
+    hashFile(h, config.modelPath);
+    fs::path weights = fs::path(config.modelPath).replace_extension(".bin");
+    if (fs::path(config.modelPath).extension() == ".xml") {
+        hashFile(h, weights.string());
+    }
+
+    hashString(h, device);
+    hashString(h, std::to_string(config.imgSize.at(0)) + "x" + std::to_string(config.imgSize.at(1)));
+
+    // ONNX Runtime ignores these, so they must not split its entries
+    if (config.runtimeType == YoloTask::RuntimeType::OpenVINO) {
+        hashString(h, config.precision);
+        hashString(h, std::to_string(config.intraOpThreads) + "/" + std::to_string(config.interOpThreads));
+        hashString(h, std::to_string(static_cast<int>(config.performanceHint)) + "/" + std::to_string(config.numStreams));
+        hashString(h, config.embedPreprocessing ? "ppp" : "raw");
+    }
+
+    std::ostringstream out;
+    out << fs::path(config.modelPath).stem().string() << "-" << std::hex << std::setw(16) << std::setfill('0') << h;
+    return out.str();
+}
+
+std::string entryPath(const std::string& runtime, const std::string& key, const std::string& extension) {
+    fs::path dir = fs::path(AppConfig::ModelCacheDir) / runtime;
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    return (dir / (key + extension)).string();
+}
+
+bool exists(const std::string& path) {
+    std::error_code ec;
+    return fs::is_regular_file(path, ec) && fs::file_size(path, ec) > 0;
+}
+
+std::string temporaryPath(const std::string& path) {
+    // Unique per writer, so processes or threads building the same entry never share a file
+    std::ostringstream out;
+    out << path << "." << getpid() << "-" << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+    return out.str();
+}
+
+bool commit(const std::string& temporaryPath, const std::string& path) {
+    std::error_code ec;
+    fs::rename(temporaryPath, path, ec);
+    if (ec) {
+        discard(temporaryPath);
+        return false;
+    }
+    return true;
+}
+
+void discard(const std::string& temporaryPath) {
+    std::error_code ec;
+    fs::remove(temporaryPath, ec);
+}
+
+} // namespace ModelCache
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include "../domain/InferenceConfig.h"
+
+/**
+ * @brief On-disk cache of compiled / optimized models.
+ *
+ * Entries live under AppConfig::ModelCacheDir/<runtime>/<key><ext>. The key
+ * hashes the model file contents (plus the OpenVINO .bin weights) together with
+ * everything that changes the compiled result: device and input size, plus for
+ * OpenVINO the precision, thread and stream configuration, performance hint and
+ * embedded preprocessing.
+ * File hashes are remembered per process until the file's size or mtime changes.
+ */
+namespace ModelCache {
+
+// Hex key for this model + configuration on the given device.
+std::string key(const InferenceConfig& config, const std::string& device);
+
+// Full path of the cache entry, creating the runtime directory if needed.
+std::string entryPath(const std::string& runtime, const std::string& key, const std::string& extension);
+
+bool exists(const std::string& path);
+
+// Writers go through a temporary file that is renamed into place on success,
+// so a crash mid-write never leaves a truncated entry behind. The temporary
+// name includes the process and thread id; the last writer's rename wins.
+std::string temporaryPath(const std::string& path);
+bool commit(const std::string& temporaryPath, const std::string& path);
+void discard(const std::string& temporaryPath);
+
+} // namespace ModelCache
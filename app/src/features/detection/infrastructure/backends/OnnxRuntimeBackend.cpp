@@ -1,5 +1,10 @@
 #include "OnnxRuntimeBackend.h"
+#include "ModelCache.h"
+#include "../SimdUtils.h"
+#include "../../../../shared/infrastructure/TaskScheduler.h"
+#include "../../../../shared/infrastructure/Tracer.h"
 #include <iostream>
+#include <chrono>
 #include <algorithm>
 #include <thread>
 #include <opencv2/opencv.hpp>
@@ -8,6 +13,71 @@
 #include <Windows.h>
 #endif
 
+namespace {
+
+// Request slots: with two, the staged pipeline preprocesses the next frame and
+// post-processes the previous one while a third stage runs the session
+constexpr int kRequestSlots = 2;
+
+#ifdef _WIN32
+std::wstring toOrtPath(const std::string& path) {
+    int size = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), static_cast<int>(path.length()), nullptr, 0);
+    std::wstring wide(size, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), static_cast<int>(path.length()), &wide[0], size);
+    return wide;
+}
+#else
+std::string toOrtPath(const std::string& path) {
+    return path;
+}
+#endif
+
+OrtCustomThreadHandle createRuntimeThread(void* options, OrtThreadWorkerFn fn, void* param) {
+    auto* scheduler = static_cast<TaskScheduler*>(options);
+    return reinterpret_cast<OrtCustomThreadHandle>(scheduler->startRuntimeThread([fn, param]() { fn(param); }, "ort"));
+}
+
+void joinRuntimeThread(OrtCustomThreadHandle handle) {
+    TaskScheduler::global().joinRuntimeThread(const_cast<void*>(reinterpret_cast<const void*>(handle)));
+}
+
+// One environment for all sessions. Its global intra-op pool is sized from the
+// scheduler's runtime budget and its threads are created by the scheduler, so
+// ORT and the app's own workers never oversubscribe the cores between them.
+Ort::Env& sharedEnv() {
+    static TaskScheduler& scheduler = TaskScheduler::global(); // outlives the env
+    static Ort::Env env = []() {
+        Ort::ThreadingOptions threading;
+        threading.SetGlobalIntraOpNumThreads(TaskScheduler::runtimeThreadBudget());
+        threading.SetGlobalInterOpNumThreads(1);
+        threading.SetGlobalSpinControl(0); // block when idle, the cores are shared
+        threading.SetGlobalCustomThreadCreationOptions(&scheduler);
+        threading.SetGlobalCustomCreateThreadFn(createRuntimeThread);
+        threading.SetGlobalCustomJoinThreadFn(joinRuntimeThread);
+        return Ort::Env(threading, ORT_LOGGING_LEVEL_WARNING, "Yolo");
+    }();
+    return env;
+}
+
+// Options shared by the first attempt and the CPU retry; the model cache adds its own on top
+Ort::SessionOptions makeSessionOptions(bool cudaEnable) {
+    Ort::SessionOptions sessionOption;
+    sessionOption.DisablePerSessionThreads();
+
+    if (cudaEnable) {
+        OrtCUDAProviderOptions cudaOption;
+        cudaOption.device_id = 0;
+        sessionOption.AppendExecutionProvider_CUDA(cudaOption);
+    }
+
+    sessionOption.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    sessionOption.SetLogSeverityLevel(3); // Default to WARNING
+    sessionOption.SetExecutionMode(ORT_SEQUENTIAL);
+    return sessionOption;
+}
+
+} // namespace
+
 OnnxRuntimeBackend::OnnxRuntimeBackend() : m_options(nullptr) {}
 
 OnnxRuntimeBackend::~OnnxRuntimeBackend() {
@@ -21,53 +91,63 @@ const char* OnnxRuntimeBackend::createSession(const InferenceConfig& config) {
         m_taskType = config.taskType;
         m_cudaEnable = config.cudaEnable;
 
-        m_env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "Yolo");
-        Ort::SessionOptions sessionOption;
-        
-        if (m_cudaEnable) {
-            OrtCUDAProviderOptions cudaOption;
-            cudaOption.device_id = 0;
-            sessionOption.AppendExecutionProvider_CUDA(cudaOption);
-        }
+        Ort::SessionOptions sessionOption = makeSessionOptions(m_cudaEnable);
 
-        sessionOption.SetIntraOpNumThreads(config.intraOpThreads);
-        sessionOption.SetInterOpNumThreads(config.interOpThreads);
-        sessionOption.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        sessionOption.SetLogSeverityLevel(3); // Default to WARNING
-        sessionOption.SetExecutionMode(ORT_SEQUENTIAL);
-
-#ifdef _WIN32
-        std::string ompThreads = std::to_string(config.intraOpThreads);
-        SetEnvironmentVariableA("OMP_NUM_THREADS", ompThreads.c_str());
-        SetEnvironmentVariableA("KMP_AFFINITY", "granularity=fine,verbose,compact,1,0");
-        SetEnvironmentVariableA("KMP_BLOCKTIME", "1");
-        SetEnvironmentVariableA("KMP_SETTINGS", "1");
-
-        int ModelPathSize = MultiByteToWideChar(CP_UTF8, 0, config.modelPath.c_str(), static_cast<int>(config.modelPath.length()), nullptr, 0);
-        std::wstring wide_model_path(ModelPathSize, L'\0');
-        MultiByteToWideChar(CP_UTF8, 0, config.modelPath.c_str(), static_cast<int>(config.modelPath.length()), &wide_model_path[0], ModelPathSize);
-        const wchar_t* modelPath = wide_model_path.c_str();
-#else
-        const char* modelPath = config.modelPath.c_str();
-#endif
+        // Optimized-model cache: on a miss ORT serializes the graph after
+        // ORT_ENABLE_ALL, on a hit that graph is loaded without re-optimizing.
+        // Layout fusions depend on the CPU, so the ISA is part of the device key.
+        auto t0 = std::chrono::steady_clock::now();
+        std::string cacheKey;
+        std::string cachePath;
+        std::string tmpPath;
+        bool cacheHit = false;
+        if (config.useModelCache) {
+            std::string device = m_cudaEnable ? "CUDA" : std::string("CPU-") + simd::isaName(simd::detectIsa());
+            cacheKey = ModelCache::key(config, device);
+            cachePath = ModelCache::entryPath("onnxruntime", cacheKey, ".onnx");
+            cacheHit = ModelCache::exists(cachePath);
+            if (cacheHit) {
+                sessionOption.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            } else {
+                tmpPath = ModelCache::temporaryPath(cachePath);
+                sessionOption.SetOptimizedModelFilePath(toOrtPath(tmpPath).c_str());
+            }
+        }
+        const auto modelPath = toOrtPath(cacheHit ? cachePath : config.modelPath);
+        const auto originalModelPath = toOrtPath(config.modelPath);
 
         try {
-            Ort::Session* sess = new Ort::Session(m_env, modelPath, sessionOption);
+            Ort::Session* sess = new Ort::Session(sharedEnv(), modelPath.c_str(), sessionOption);
             m_sessionPool.push_back(sess);
         } catch (const std::exception& e) {
-            if (m_cudaEnable) {
-                std::cout << "[ONNX]: CUDA init failed (" << e.what() << "). Fallback to CPU." << std::endl;
+            if (m_cudaEnable || cacheHit) {
+                std::cout << "[ONNX]: Session init failed (" << e.what() << "). Retrying on CPU from the original model." << std::endl;
                 m_cudaEnable = false;
-                sessionOption = Ort::SessionOptions();
-                sessionOption.SetIntraOpNumThreads(config.intraOpThreads);
-                sessionOption.SetInterOpNumThreads(config.interOpThreads);
-                Ort::Session* sess = new Ort::Session(m_env, modelPath, sessionOption);
+                cacheHit = false;
+                cachePath.clear();
+                if (!tmpPath.empty()) ModelCache::discard(tmpPath);
+                sessionOption = makeSessionOptions(false);
+                Ort::Session* sess = new Ort::Session(sharedEnv(), originalModelPath.c_str(), sessionOption);
                 m_sessionPool.push_back(sess);
             } else throw;
         }
 
-        // Single session for now, pooling can be re-added if needed
-        // For simplicity in porting, I'll stick to 1 session for now or use config
+        if (!cacheHit && !cachePath.empty()) {
+            if (!ModelCache::commit(tmpPath, cachePath)) {
+                std::cerr << "[ONNX]: Could not write model cache " << cachePath << std::endl;
+            }
+        }
+
+        auto loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (config.useModelCache) {
+            std::cout << "[ONNX]: Model cache " << (cacheHit ? "HIT" : "MISS") << " " << cacheKey
+                      << " (" << loadMs << " ms)" << std::endl;
+        } else {
+            std::cout << "[ONNX]: Session created (" << loadMs << " ms, cache disabled)" << std::endl;
+        }
+
+        // Input and output names are the same for every session in the pool
 
         Ort::AllocatorWithDefaultOptions allocator;
         Ort::Session* primary = m_sessionPool.front();
@@ -88,6 +168,32 @@ const char* OnnxRuntimeBackend::createSession(const InferenceConfig& config) {
             m_outputNodeNames.push_back(m_outputNodeNameStorage.back().c_str());
         }
 
+        // Input: NCHW float32, dynamic dims resolved from the configured image size
+        m_inputDims = primary->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (m_inputDims.size() != 4) m_inputDims.assign(4, -1);
+        if (m_inputDims[0] <= 0) m_inputDims[0] = 1;
+        if (m_inputDims[1] <= 0) m_inputDims[1] = 3;
+        if (m_inputDims[2] <= 0) m_inputDims[2] = config.imgSize.at(0);
+        if (m_inputDims[3] <= 0) m_inputDims[3] = config.imgSize.at(1);
+        size_t inputElements = (size_t)(m_inputDims[0] * m_inputDims[1] * m_inputDims[2] * m_inputDims[3]);
+
+        m_useBinding = resolveOutputShapes(*primary);
+        if (!m_useBinding) {
+            std::cout << "[ONNX]: Dynamic output shape, IoBinding disabled (outputs allocated per run)." << std::endl;
+        }
+
+        // Run() is thread-safe on one session, so the slots share it
+        m_slots.clear();
+        m_slots.resize(kRequestSlots);
+        for (RequestSlot& slot : m_slots) {
+            slot.input.allocate(inputElements * sizeof(float));
+            slot.inputTensor = Ort::Value::CreateTensor<float>(
+                Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU),
+                slot.input.as<float>(), inputElements,
+                m_inputDims.data(), m_inputDims.size());
+            if (m_useBinding) bindOutputs(*primary, slot);
+        }
+
         return nullptr; // OK
     } catch (const std::exception& e) {
         std::cerr << "[ONNX]: Create session failed: " << e.what() << std::endl;
@@ -95,35 +201,102 @@ const char* OnnxRuntimeBackend::createSession(const InferenceConfig& config) {
     }
 }
 
-InferenceOutput OnnxRuntimeBackend::runInference(float* blobData, const std::vector<int64_t>& inputDims) {
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU), 
-        blobData, 3 * inputDims[2] * inputDims[3], 
-        inputDims.data(), inputDims.size());
+bool OnnxRuntimeBackend::resolveOutputShapes(Ort::Session& session) {
+    m_outputShapes.clear();
+
+    size_t outputCount = m_outputNodeNames.size();
+    for (size_t i = 0; i < outputCount; i++) {
+        auto info = session.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo();
+        if (info.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) return false;
+
+        std::vector<int64_t> shape = info.GetShape();
+        if (!shape.empty() && shape[0] <= 0) shape[0] = 1; // dynamic batch, we always run one image
+        for (int64_t d : shape) {
+            if (d <= 0) return false;
+        }
+        m_outputShapes.push_back(shape);
+    }
+
+    // Resolve which output is the detection head once instead of per frame
+    m_primaryOutput = 0;
+    m_secondaryOutput = 1;
+    if (outputCount > 1 && m_outputShapes[0].size() == 4 && m_outputShapes[1].size() == 3) {
+        std::swap(m_primaryOutput, m_secondaryOutput);
+    }
+    return true;
+}
+
+void OnnxRuntimeBackend::bindOutputs(Ort::Session& session, RequestSlot& slot) {
+    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+    slot.binding = Ort::IoBinding(session);
+    slot.binding.BindInput(m_inputNodeNames[0], slot.inputTensor);
+    for (size_t i = 0; i < m_outputShapes.size(); i++) {
+        const std::vector<int64_t>& shape = m_outputShapes[i];
+        size_t elements = 1;
+        for (int64_t d : shape) elements *= (size_t)d;
+        slot.outputBuffers.emplace_back(elements * sizeof(float));
+        slot.outputTensors.push_back(Ort::Value::CreateTensor<float>(
+            memInfo, slot.outputBuffers.back().as<float>(), elements,
+            shape.data(), shape.size()));
+        slot.binding.BindOutput(m_outputNodeNames[i], slot.outputTensors.back());
+    }
+}
+
+void* OnnxRuntimeBackend::inputBuffer(int slot) {
+    return m_slots.at(slot).input.data();
+}
+
+InferenceOutput OnnxRuntimeBackend::runInference(int slot) {
+    YOLO_TRACE_SCOPE("onnxruntime.infer");
+    RequestSlot& request = m_slots.at(slot);
+    if (m_useBinding) {
+        // Bound to the primary session; the pool holds a single session
+        m_sessionPool.front()->Run(m_options, request.binding);
+        return outputs(slot);
+    }
 
     size_t poolSize = m_sessionPool.size();
     Ort::Session* sess = m_sessionPool[m_sessionIndex.fetch_add(1) % poolSize];
     
-    m_lastOutputs = sess->Run(m_options, m_inputNodeNames.data(), &inputTensor, 1, m_outputNodeNames.data(), m_outputNodeNames.size());
+    request.lastOutputs = sess->Run(m_options, m_inputNodeNames.data(), &request.inputTensor, 1, m_outputNodeNames.data(), m_outputNodeNames.size());
 
-    InferenceOutput output;
-    
-    if (m_lastOutputs.size() > 1) {
-        auto shape0 = m_lastOutputs[0].GetTensorTypeAndShapeInfo().GetShape();
-        auto shape1 = m_lastOutputs[1].GetTensorTypeAndShapeInfo().GetShape();
+    if (request.lastOutputs.size() > 1) {
+        auto shape0 = request.lastOutputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        auto shape1 = request.lastOutputs[1].GetTensorTypeAndShapeInfo().GetShape();
         
         if (shape0.size() == 4 && shape1.size() == 3) {
-            std::swap(m_lastOutputs[0], m_lastOutputs[1]);
-            std::swap(shape0, shape1);
+            std::swap(request.lastOutputs[0], request.lastOutputs[1]);
         }
-        
-        output.primaryData = m_lastOutputs[0].GetTensorMutableData<void>();
-        output.primaryShape = shape0;
-        output.secondaryData = m_lastOutputs[1].GetTensorMutableData<void>();
-        output.secondaryShape = shape1;
+    }
+
+    return outputs(slot);
+}
+
+InferenceOutput OnnxRuntimeBackend::outputs(int slot) {
+    RequestSlot& request = m_slots.at(slot);
+    InferenceOutput output;
+
+    if (m_useBinding) {
+        output.primaryData = request.outputBuffers[m_primaryOutput].data();
+        output.primaryShape = m_outputShapes[m_primaryOutput];
+        if (request.outputBuffers.size() > 1) {
+            output.secondaryData = request.outputBuffers[m_secondaryOutput].data();
+            output.secondaryShape = m_outputShapes[m_secondaryOutput];
+        } else {
+            output.secondaryData = nullptr;
+        }
+        return output;
+    }
+    
+    std::vector<Ort::Value>& lastOutputs = request.lastOutputs;
+    if (lastOutputs.size() > 1) {
+        output.primaryData = lastOutputs[0].GetTensorMutableData<void>();
+        output.primaryShape = lastOutputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        output.secondaryData = lastOutputs[1].GetTensorMutableData<void>();
+        output.secondaryShape = lastOutputs[1].GetTensorTypeAndShapeInfo().GetShape();
     } else {
-        output.primaryData = m_lastOutputs[0].GetTensorMutableData<void>();
-        output.primaryShape = m_lastOutputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        output.primaryData = lastOutputs[0].GetTensorMutableData<void>();
+        output.primaryShape = lastOutputs[0].GetTensorTypeAndShapeInfo().GetShape();
         output.secondaryData = nullptr;
     }
 
@@ -131,11 +304,9 @@ InferenceOutput OnnxRuntimeBackend::runInference(float* blobData, const std::vec
 }
 
 void OnnxRuntimeBackend::warmUp(const std::vector<int>& imgSize) {
+    (void)imgSize; // the input buffers are already sized for the session
     if (m_sessionPool.empty()) return;
-    cv::Mat dummy = cv::Mat::zeros(imgSize[0], imgSize[1], CV_32FC3);
-    float* data = (float*)dummy.data;
-    std::vector<int64_t> dims = {1, 3, (int64_t)imgSize[0], (int64_t)imgSize[1]};
-    runInference(data, dims);
+    for (int slot = 0; slot < slotCount(); ++slot) runInference(slot);
 }
 
 std::vector<int64_t> OnnxRuntimeBackend::getOutputShape() const {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IInferenceBackend.h"
+#include "AlignedBuffer.h"
 #include "onnxruntime_cxx_api.h"
 #include <atomic>
 #include <memory>
@@ -12,12 +13,28 @@ public:
     ~OnnxRuntimeBackend() override;
 
     const char* createSession(const InferenceConfig& config) override;
-    InferenceOutput runInference(float* blobData, const std::vector<int64_t>& inputDims) override;
+    int slotCount() const override { return static_cast<int>(m_slots.size()); }
+    void* inputBuffer(int slot = 0) override;
+    InferenceOutput runInference(int slot = 0) override;
+    InferenceOutput outputs(int slot) override;
     void warmUp(const std::vector<int>& imgSize) override;
     std::vector<int64_t> getOutputShape() const override;
 
 private:
-    Ort::Env m_env;
+    // One per in-flight frame: its own input, IoBinding and output buffers, so a
+    // slot can be preprocessed or post-processed while another one runs
+    struct RequestSlot {
+        AlignedBuffer input;
+        Ort::Value inputTensor{nullptr};
+        Ort::IoBinding binding{nullptr};
+        std::vector<AlignedBuffer> outputBuffers;
+        std::vector<Ort::Value> outputTensors;
+        std::vector<Ort::Value> lastOutputs; // unbound fallback: outputs of the last Run()
+    };
+
+    bool resolveOutputShapes(Ort::Session& session);
+    void bindOutputs(Ort::Session& session, RequestSlot& slot);
+
     std::vector<Ort::Session*> m_sessionPool;
     std::vector<std::string> m_inputNodeNameStorage;
     std::vector<std::string> m_outputNodeNameStorage;
@@ -28,5 +45,14 @@ private:
     std::atomic<size_t> m_sessionIndex{0};
     bool m_cudaEnable = false;
     YoloTask::TaskType m_taskType;
-    std::vector<Ort::Value> m_lastOutputs;
+
+    std::vector<RequestSlot> m_slots;
+    std::vector<int64_t> m_inputDims;
+
+    // IoBinding path: outputs written into persistent buffers, no per-frame allocation.
+    // Falls back to Run() returning fresh outputs when an output shape is dynamic.
+    bool m_useBinding = false;
+    std::vector<std::vector<int64_t>> m_outputShapes;
+    size_t m_primaryOutput = 0;   // detection head (rank 3)
+    size_t m_secondaryOutput = 1; // segmentation prototypes (rank 4), if present
 };
@@ -1,21 +1,140 @@
 #include "OpenVinoBackend.h"
+#include "ModelCache.h"
+#include "../../../../shared/infrastructure/Tracer.h"
 #include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <openvino/core/preprocess/pre_post_process.hpp>
 #include <opencv2/opencv.hpp>
 
 OpenVinoBackend::OpenVinoBackend() {}
 
-OpenVinoBackend::~OpenVinoBackend() {}
+OpenVinoBackend::~OpenVinoBackend() {
+    waitForPending();
+}
+
+std::shared_ptr<ov::Model> OpenVinoBackend::readModel(const InferenceConfig& config) {
+    std::shared_ptr<ov::Model> model = m_core.read_model(config.modelPath);
+
+    if (config.embedPreprocessing) {
+        // Accept the letterboxed frame as captured (u8, NHWC, BGR) and let the
+        // compiled graph do the type conversion, channel swap, scaling and layout.
+        ov::preprocess::PrePostProcessor ppp(model);
+        ov::preprocess::InputInfo& input = ppp.input();
+        input.tensor()
+            .set_element_type(ov::element::u8)
+            .set_layout("NHWC")
+            .set_color_format(ov::preprocess::ColorFormat::BGR);
+        input.preprocess()
+            .convert_element_type(ov::element::f32)
+            .convert_color(ov::preprocess::ColorFormat::RGB)
+            .scale(255.0f);
+        input.model().set_layout("NCHW");
+        model = ppp.build();
+    }
+    return model;
+}
 
 const char* OpenVinoBackend::createSession(const InferenceConfig& config) {
     try {
         m_taskType = config.taskType;
 
-        std::shared_ptr<ov::Model> model = m_core.read_model(config.modelPath);
-        
-        ov::AnyMap ovConfig = {ov::hint::performance_mode(ov::hint::PerformanceMode::LATENCY)};
+        m_inputFormat = config.embedPreprocessing ? InputFormat::InterleavedU8 : InputFormat::PlanarF32;
         
-        m_compiledModel = m_core.compile_model(model, "CPU", ovConfig);
-        m_inferRequest = m_compiledModel.create_infer_request();
+        ov::AnyMap ovConfig;
+        if (config.performanceHint == YoloTask::PerformanceHint::Throughput) {
+            ovConfig.insert(ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT));
+            if (config.numStreams > 0) ovConfig.insert(ov::num_streams(config.numStreams));
+        } else {
+            ovConfig.insert(ov::hint::performance_mode(ov::hint::PerformanceMode::LATENCY));
+        }
+        ovConfig.insert(ov::inference_num_threads(config.intraOpThreads));
+        if (!config.precision.empty()) {
+            ovConfig.insert(ov::hint::inference_precision(ov::element::Type(config.precision)));
+        }
+
+        waitForPending();
+        m_inferRequests.clear();
+        m_inputTensors.clear();
+
+        // Import a previously exported blob when one matches this model and
+        // configuration; skips read_model, preprocessing build and compilation.
+        auto t0 = std::chrono::steady_clock::now();
+        std::string cacheKey;
+        std::string cachePath;
+        bool cacheHit = false;
+        if (config.useModelCache) {
+            cacheKey = ModelCache::key(config, "CPU");
+            cachePath = ModelCache::entryPath("openvino", cacheKey, ".blob");
+            if (ModelCache::exists(cachePath)) {
+                try {
+                    std::ifstream blob(cachePath, std::ios::binary);
+                    m_compiledModel = m_core.import_model(blob, "CPU", ovConfig);
+                    cacheHit = true;
+                } catch (const std::exception& e) {
+                    std::cerr << "[OpenVINO]: Cached model unusable (" << e.what() << "), recompiling." << std::endl;
+                }
+            }
+        }
+
+        if (!cacheHit) {
+            m_compiledModel = m_core.compile_model(readModel(config), "CPU", ovConfig);
+            // The compiled model is good either way; a failed export only costs the next load
+            if (!cachePath.empty()) {
+                std::string tmpPath = ModelCache::temporaryPath(cachePath);
+                bool written = false;
+                try {
+                    std::ofstream blob(tmpPath, std::ios::binary);
+                    m_compiledModel.export_model(blob);
+                    blob.close();
+                    written = blob.good();
+                } catch (const std::exception& e) {
+                    std::cerr << "[OpenVINO]: Model export failed: " << e.what() << std::endl;
+                }
+                if (!written) {
+                    ModelCache::discard(tmpPath);
+                    std::cerr << "[OpenVINO]: Could not write model cache " << cachePath << std::endl;
+                } else if (!ModelCache::commit(tmpPath, cachePath)) {
+                    std::cerr << "[OpenVINO]: Could not write model cache " << cachePath << std::endl;
+                }
+            }
+        }
+
+        auto loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (config.useModelCache) {
+            std::cout << "[OpenVINO]: Model cache " << (cacheHit ? "HIT" : "MISS") << " " << cacheKey
+                      << " (" << loadMs << " ms)" << std::endl;
+        } else {
+            std::cout << "[OpenVINO]: Model compiled (" << loadMs << " ms, cache disabled)" << std::endl;
+        }
+
+        // At least two requests even under LATENCY, so the next frame is
+        // preprocessed (and the previous one post-processed) while one infers
+        uint32_t optimal = m_compiledModel.get_property(ov::optimal_number_of_infer_requests);
+        int requestCount = std::clamp<int>(static_cast<int>(optimal), 2, 8);
+
+        // Write frames straight into each request's input tensor. Dynamic models get
+        // one tensor of the configured size per request, set once here instead of per frame.
+        const ov::Output<const ov::Node> input = m_compiledModel.input();
+        for (int i = 0; i < requestCount; ++i) {
+            ov::InferRequest request = m_compiledModel.create_infer_request();
+            if (input.get_partial_shape().is_static()) {
+                m_inputTensors.push_back(request.get_input_tensor());
+            } else {
+                size_t h = (size_t)config.imgSize.at(0);
+                size_t w = (size_t)config.imgSize.at(1);
+                ov::Shape shape = (m_inputFormat == InputFormat::InterleavedU8) ? ov::Shape{1, h, w, 3} : ov::Shape{1, 3, h, w};
+                m_inputTensors.push_back(ov::Tensor(input.get_element_type(), shape));
+                request.set_input_tensor(m_inputTensors.back());
+            }
+            m_inferRequests.push_back(std::move(request));
+        }
+        std::cout << "[OpenVINO]: " << requestCount << " infer requests ("
+                  << (config.performanceHint == YoloTask::PerformanceHint::Throughput ? "THROUGHPUT" : "LATENCY")
+                  << ", optimal " << optimal << ")" << std::endl;
 
         return nullptr; // OK
     } catch (const std::exception& e) {
@@ -24,19 +143,56 @@ const char* OpenVinoBackend::createSession(const InferenceConfig& config) {
     }
 }
 
-InferenceOutput OpenVinoBackend::runInference(float* blobData, const std::vector<int64_t>& inputDims) {
-    ov::Shape shape = { (size_t)inputDims[0], (size_t)inputDims[1], (size_t)inputDims[2], (size_t)inputDims[3] };
-    ov::Tensor input_tensor(ov::element::f32, shape, blobData);
-    m_inferRequest.set_input_tensor(input_tensor);
+void* OpenVinoBackend::inputBuffer(int slot) {
+    return m_inputTensors.at(slot).data();
+}
+
+InferenceOutput OpenVinoBackend::runInference(int slot) {
+    {
+        YOLO_TRACE_SCOPE("openvino.infer");
+        m_inferRequests.at(slot).infer();
+    }
+    return outputs(slot);
+}
+
+void OpenVinoBackend::startInference(int slot, InferenceCallback onDone) {
+    ov::InferRequest& request = m_inferRequests.at(slot);
+    const int64_t traceBegin = YOLO_TRACE_NOW();
+    request.set_callback([slot, onDone, traceBegin](std::exception_ptr error) {
+        YOLO_TRACE_COMPLETE("openvino.infer", traceBegin);
+        const char* status = nullptr;
+        if (error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                std::cerr << "[OpenVINO]: Async inference failed: " << e.what() << std::endl;
+            }
+            status = "Inference failed.";
+        }
+        onDone(slot, status);
+    });
+    request.start_async();
+}
 
-    m_inferRequest.infer();
+void OpenVinoBackend::waitForPending() {
+    for (ov::InferRequest& request : m_inferRequests) {
+        // wait() rethrows the exception of a failed async run
+        try {
+            request.wait();
+        } catch (const std::exception& e) {
+            std::cerr << "[OpenVINO]: Pending inference failed: " << e.what() << std::endl;
+        }
+    }
+}
 
+InferenceOutput OpenVinoBackend::outputs(int slot) {
+    ov::InferRequest& request = m_inferRequests.at(slot);
     InferenceOutput output;
     
-    ov::Tensor out0 = m_inferRequest.get_output_tensor(0);
+    ov::Tensor out0 = request.get_output_tensor(0);
     
     if (m_compiledModel.outputs().size() > 1) {
-        ov::Tensor out1 = m_inferRequest.get_output_tensor(1);
+        ov::Tensor out1 = request.get_output_tensor(1);
         
         // Ensure out0 is the detection tensor (rank 3) and out1 is the prototype tensor (rank 4)
         if (out0.get_shape().size() == 4 && out1.get_shape().size() == 3) {
@@ -60,9 +216,11 @@ InferenceOutput OpenVinoBackend::runInference(float* blobData, const std::vector
 }
 
 void OpenVinoBackend::warmUp(const std::vector<int>& imgSize) {
-    cv::Mat dummy = cv::Mat::zeros(imgSize[0], imgSize[1], CV_32FC3);
-    std::vector<int64_t> dims = {1, 3, (int64_t)imgSize[0], (int64_t)imgSize[1]};
-    runInference((float*)dummy.data, dims);
+    (void)imgSize; // the input tensor is already sized for the session
+    for (int slot = 0; slot < slotCount(); ++slot) {
+        std::memset(m_inputTensors[slot].data(), 0, m_inputTensors[slot].get_byte_size());
+        runInference(slot);
+    }
 }
 
 std::vector<int64_t> OpenVinoBackend::getOutputShape() const {
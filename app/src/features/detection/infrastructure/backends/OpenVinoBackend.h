@@ -11,14 +11,27 @@ public:
     ~OpenVinoBackend() override;
 
     const char* createSession(const InferenceConfig& config) override;
-    InferenceOutput runInference(float* blobData, const std::vector<int64_t>& inputDims) override;
+    int slotCount() const override { return static_cast<int>(m_inferRequests.size()); }
+    void* inputBuffer(int slot = 0) override;
+    InferenceOutput runInference(int slot = 0) override;
+    void startInference(int slot, InferenceCallback onDone) override;
+    InferenceOutput outputs(int slot) override;
+    void waitForPending() override;
     void warmUp(const std::vector<int>& imgSize) override;
     std::vector<int64_t> getOutputShape() const override;
+    InputFormat inputFormat() const override { return m_inputFormat; }
 
 private:
+    std::shared_ptr<ov::Model> readModel(const InferenceConfig& config);
+
     ov::Core m_core;
     ov::CompiledModel m_compiledModel;
-    ov::InferRequest m_inferRequest;
+
+    // One infer request per in-flight frame; each owns its input tensor,
+    // written in place by the preprocessor
+    std::vector<ov::InferRequest> m_inferRequests;
+    std::vector<ov::Tensor> m_inputTensors;
     
     YoloTask::TaskType m_taskType;
+    InputFormat m_inputFormat = InputFormat::PlanarF32;
 };
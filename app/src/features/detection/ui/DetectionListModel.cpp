@@ -1,6 +1,7 @@
 #include "DetectionListModel.h"
 #include <QVariant>
 #include <QDebug>
+#include "../../../shared/infrastructure/Tracer.h"
 #include <algorithm>
 
 DetectionListModel::DetectionListModel(QObject *parent)
@@ -62,6 +63,7 @@ void DetectionListModel::updateDetections(const std::vector<DetectionResult>& re
                                           const std::vector<std::string>& classNames, 
                                           const QSize& frameSize)
 {
+    YOLO_TRACE_SCOPE("ui.updateDetections");
     if (results.empty() && m_detections.empty() && m_frameSize == frameSize) return;
     
     if (m_frameSize != frameSize) {
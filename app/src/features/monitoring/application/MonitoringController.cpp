@@ -1,5 +1,9 @@
 #include "MonitoringController.h"
 #include <QString>
+#include <QDateTime>
+#include "../../../shared/domain/AppConfig.h"
+#include "../../../shared/domain/UiLogger.h"
+#include "../../../shared/infrastructure/Tracer.h"
 
 MonitoringController::MonitoringController(SystemMonitorWorker *worker, QObject *parent)
     : QObject(parent)
@@ -11,6 +15,41 @@ MonitoringController::~MonitoringController()
 {
 }
 
+bool MonitoringController::tracingAvailable() const
+{
+    return Tracer::compiledIn();
+}
+
+bool MonitoringController::tracingEnabled() const
+{
+    return Tracer::instance().isEnabled();
+}
+
+void MonitoringController::setTracingEnabled(bool enabled)
+{
+    if (!Tracer::compiledIn() || enabled == tracingEnabled()) return;
+    // Each recording session starts with an empty trace
+    if (enabled) Tracer::instance().clear();
+    Tracer::instance().setEnabled(enabled);
+    UiLogger::ctrl(QString("MonitoringController: Tracing ") + (enabled ? "started" : "stopped"));
+    emit tracingEnabledChanged();
+}
+
+QString MonitoringController::dumpTrace()
+{
+    if (!Tracer::compiledIn()) return QString();
+
+    QString path = QString("%1/trace-%2.json")
+        .arg(AppConfig::TraceDir, QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+    long long events = Tracer::instance().dump(path.toStdString());
+    if (events < 0) {
+        UiLogger::ctrl("MonitoringController: Could not write trace " + path);
+        return QString();
+    }
+    UiLogger::ctrl("MonitoringController: Trace written → " + path + " (" + QString::number(events) + " events)");
+    return path;
+}
+
 void MonitoringController::updateStats(const SystemStats& stats)
 {
     if (m_statsText != stats.formatted()) {
@@ -9,6 +9,8 @@ class SystemMonitorWorker;
 class MonitoringController : public QObject {
     Q_OBJECT
     Q_PROPERTY(QString statsText READ statsText NOTIFY statsTextChanged)
+    Q_PROPERTY(bool tracingAvailable READ tracingAvailable CONSTANT)
+    Q_PROPERTY(bool tracingEnabled READ tracingEnabled WRITE setTracingEnabled NOTIFY tracingEnabledChanged)
 
 public:
     explicit MonitoringController(SystemMonitorWorker *worker, QObject *parent = nullptr);
@@ -16,11 +18,19 @@ public:
 
     QString statsText() const { return m_statsText; }
 
+    // Pipeline trace recording; only available in YOLOAPP_ENABLE_TRACING builds
+    bool tracingAvailable() const;
+    bool tracingEnabled() const;
+    void setTracingEnabled(bool enabled);
+    // Writes the recorded events as Chrome trace JSON; returns the file path, or "" on failure
+    Q_INVOKABLE QString dumpTrace();
+
 public slots:
     void updateStats(const SystemStats& stats);
 
 signals:
     void statsTextChanged();
+    void tracingEnabledChanged();
 
 private:
     SystemMonitorWorker *m_worker;
@@ -1,11 +1,15 @@
 #include "SystemMonitorWorker.h"
+#include "../../../shared/infrastructure/TaskScheduler.h"
+#include "../../../shared/infrastructure/ThreadNames.h"
+#include "../../../shared/domain/AppConfig.h"
+#include <QStringList>
 
 SystemMonitorWorker::SystemMonitorWorker(ISystemMonitor *monitor, QObject *parent)
     : QObject(parent)
     , m_monitor(monitor)
     , m_timer(new QTimer(this))
 {
-    m_timer->setInterval(1000);
+    m_timer->setInterval(AppConfig::MonitorPollMs);
     connect(m_timer, &QTimer::timeout, this, &SystemMonitorWorker::onTimeout);
 }
 
@@ -17,6 +21,7 @@ SystemMonitorWorker::~SystemMonitorWorker()
 void SystemMonitorWorker::start()
 {
     if (!m_timer->isActive()) {
+        ThreadNames::setCurrent("monitoring");
         m_timer->start();
         onTimeout(); // Initial poll
     }
@@ -30,6 +35,12 @@ void SystemMonitorWorker::stop()
 void SystemMonitorWorker::onTimeout()
 {
     if (m_monitor) {
-        emit statsUpdated(m_monitor->poll());
+        SystemStats stats = m_monitor->poll();
+        QStringList load;
+        for (double busy : TaskScheduler::global().takeUtilization()) {
+            load << QString::number(qRound(busy * 100.0));
+        }
+        stats.schedulerLoad = load.join(' ');
+        emit statsUpdated(stats);
     }
 }
@@ -6,11 +6,18 @@ struct SystemStats {
     double  cpuPercent    = 0.0;
     QString systemMemory;
     QString processMemory;
+    QString schedulerLoad;  // per-worker busy %, e.g. "45 30 12"
+    QString threadCpu;      // % of a core per named thread or pool, e.g. "inference 85, scheduler×3 40"
+    QString contextSwitches;
 
     QString formatted() const {
-        return QString("CPU: %1%\nSYS: %2\nAPP: %3")
+        QString text = QString("CPU: %1%\nSYS: %2\nAPP: %3")
             .arg(cpuPercent, 0, 'f', 1)
             .arg(systemMemory)
             .arg(processMemory);
+        if (!schedulerLoad.isEmpty()) text += QString("\nSCHED: %1 %").arg(schedulerLoad);
+        if (!threadCpu.isEmpty()) text += QString("\nTHR: %1").arg(threadCpu);
+        if (!contextSwitches.isEmpty()) text += QString("\nCSW: %1").arg(contextSwitches);
+        return text;
     }
 };
@@ -0,0 +1,304 @@
+#include "LinuxSystemMonitor.h"
+#include "../../../shared/infrastructure/ThreadNames.h"
+#include <QStringList>
+#include <algorithm>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+    // Re-reads a procfs file from the start; procfs regenerates it on every read at offset 0
+    bool readProc(int fd, char* buffer, size_t size) {
+        if (fd < 0) return false;
+        ssize_t length = pread(fd, buffer, size - 1, 0);
+        if (length <= 0) return false;
+        buffer[length] = '\0';
+        return true;
+    }
+
+    // Fields of a */stat line (numbered as in proc(5)); comm may contain spaces and parentheses
+    struct StatFields {
+        std::string comm;
+        uint64_t utime = 0;   // 14
+        uint64_t stime = 0;   // 15
+        uint64_t rss = 0;     // 24, pages
+    };
+
+    bool parseStat(const char* text, StatFields& out) {
+        const char* commBegin = std::strchr(text, '(');
+        const char* commEnd = std::strrchr(text, ')');
+        if (!commBegin || !commEnd || commEnd < commBegin) return false;
+        out.comm.assign(commBegin + 1, commEnd);
+
+        const char* cursor = commEnd + 1;
+        for (int field = 3; field <= 24; ++field) {
+            while (*cursor == ' ') ++cursor;
+            if (*cursor == '\0') return false;
+            char* end = nullptr;
+            const uint64_t value = std::strtoull(cursor, &end, 10);
+            if (field == 14) out.utime = value;
+            else if (field == 15) out.stime = value;
+            else if (field == 24) out.rss = value;
+            cursor = end != cursor ? end : std::strchr(cursor, ' ');
+            if (!cursor) return false;
+        }
+        return true;
+    }
+
+    // Value of a "Key:   1234 kB" line
+    uint64_t readKb(const char* text, const char* key) {
+        const char* line = std::strstr(text, key);
+        return line ? std::strtoull(line + std::strlen(key), nullptr, 10) : 0;
+    }
+
+    int openProc(const std::string& path) {
+        return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+
+    // "scheduler-3" and "ort-1" are summed as one pool
+    std::string poolName(const std::string& name) {
+        size_t end = name.size();
+        while (end > 0 && std::isdigit(static_cast<unsigned char>(name[end - 1]))) --end;
+        if (end == name.size()) return name;
+        while (end > 0 && (name[end - 1] == '-' || name[end - 1] == '_' || name[end - 1] == '.')) --end;
+        return end > 0 ? name.substr(0, end) : name;
+    }
+}
+#endif
+
+LinuxSystemMonitor::LinuxSystemMonitor()
+{
+    initialize();
+}
+
+LinuxSystemMonitor::~LinuxSystemMonitor()
+{
+    cleanup();
+}
+
+void LinuxSystemMonitor::initialize()
+{
+#ifdef Q_OS_LINUX
+    m_ticksPerSec = std::max(1L, sysconf(_SC_CLK_TCK));
+    m_pageSize = std::max(1L, sysconf(_SC_PAGESIZE));
+    m_numProcessors = static_cast<int>(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+
+    m_statFd = openProc("/proc/self/stat");
+    m_meminfoFd = openProc("/proc/meminfo");
+    m_smapsFd = openProc("/proc/self/smaps_rollup");
+    m_taskDir = opendir("/proc/self/task");
+
+    // Baselines, so the first poll reports rates since construction
+    char buffer[1024];
+    StatFields stat;
+    if (readProc(m_statFd, buffer, sizeof(buffer)) && parseStat(buffer, stat)) {
+        m_lastProcessTicks = stat.utime + stat.stime;
+        m_processName = stat.comm;
+    }
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        m_lastVoluntary = static_cast<uint64_t>(usage.ru_nvcsw);
+        m_lastInvoluntary = static_cast<uint64_t>(usage.ru_nivcsw);
+    }
+    m_lastPoll = std::chrono::steady_clock::now();
+#endif
+}
+
+void LinuxSystemMonitor::cleanup()
+{
+#ifdef Q_OS_LINUX
+    for (auto& task : m_tasks) {
+        if (task.second.fd >= 0) close(task.second.fd);
+    }
+    m_tasks.clear();
+    for (int* fd : {&m_statFd, &m_meminfoFd, &m_smapsFd}) {
+        if (*fd >= 0) close(*fd);
+        *fd = -1;
+    }
+    if (m_taskDir) closedir(static_cast<DIR*>(m_taskDir));
+    m_taskDir = nullptr;
+#endif
+}
+
+SystemStats LinuxSystemMonitor::poll()
+{
+    SystemStats stats;
+#ifdef Q_OS_LINUX
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsedSec = std::max(1e-3, std::chrono::duration<double>(now - m_lastPoll).count());
+    m_lastPoll = now;
+
+    uint64_t rssPages = 0;
+    stats.cpuPercent      = getCpuUsage(elapsedSec, rssPages);
+    stats.threadCpu       = getThreadCpu(elapsedSec);
+    stats.systemMemory    = getSystemMemoryInfo();
+    stats.processMemory   = getProcessMemoryInfo(rssPages);
+    stats.contextSwitches = getContextSwitches(elapsedSec);
+#else
+    stats.systemMemory  = "N/A";
+    stats.processMemory = "N/A";
+#endif
+    return stats;
+}
+
+double LinuxSystemMonitor::getCpuUsage(double elapsedSec, uint64_t& rssPages)
+{
+#ifdef Q_OS_LINUX
+    char buffer[1024];
+    StatFields stat;
+    if (!readProc(m_statFd, buffer, sizeof(buffer)) || !parseStat(buffer, stat)) return 0.0;
+
+    rssPages = stat.rss;
+    const uint64_t ticks = stat.utime + stat.stime;
+    const uint64_t delta = ticks >= m_lastProcessTicks ? ticks - m_lastProcessTicks : 0;
+    m_lastProcessTicks = ticks;
+    // Process share of all cores
+    return 100.0 * delta / (elapsedSec * m_ticksPerSec * m_numProcessors);
+#else
+    Q_UNUSED(elapsedSec);
+    Q_UNUSED(rssPages);
+    return 0.0;
+#endif
+}
+
+QString LinuxSystemMonitor::getThreadCpu(double elapsedSec)
+{
+#ifdef Q_OS_LINUX
+    DIR* dir = static_cast<DIR*>(m_taskDir);
+    if (!dir) return QString();
+    rewinddir(dir);
+
+    struct Group {
+        std::string name;
+        double percent = 0.0; // of one core
+        int threads = 0;
+    };
+    std::vector<Group> groups;
+    const long pid = static_cast<long>(getpid());
+    char buffer[1024];
+
+    for (auto& task : m_tasks) task.second.seen = false;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+        const long tid = std::strtol(entry->d_name, nullptr, 10);
+
+        auto it = m_tasks.find(tid);
+        const bool fresh = it == m_tasks.end();
+        if (fresh) {
+            TaskSample sample;
+            sample.fd = openProc("/proc/self/task/" + std::string(entry->d_name) + "/stat");
+            if (sample.fd < 0) continue;
+            it = m_tasks.emplace(tid, sample).first;
+        }
+
+        StatFields stat;
+        if (!readProc(it->second.fd, buffer, sizeof(buffer)) || !parseStat(buffer, stat)) continue; // exiting
+        it->second.seen = true;
+
+        const uint64_t ticks = stat.utime + stat.stime;
+        const uint64_t delta = !fresh && ticks >= it->second.ticks ? ticks - it->second.ticks : 0;
+        it->second.ticks = ticks;
+
+        std::string label = ThreadNames::lookup(tid);
+        if (label.empty()) {
+            if (tid == pid) label = "gui";
+            else if (stat.comm == m_processName || ThreadNames::isRegisteredName(stat.comm)) label = "runtime";
+            else label = stat.comm;
+        }
+        label = poolName(label);
+
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) { return g.name == label; });
+        if (group == groups.end()) group = groups.insert(groups.end(), Group{label});
+        group->percent += 100.0 * delta / (elapsedSec * m_ticksPerSec);
+        ++group->threads;
+    }
+
+    for (auto it = m_tasks.begin(); it != m_tasks.end();) {
+        if (it->second.seen) { ++it; continue; }
+        close(it->second.fd);
+        it = m_tasks.erase(it);
+    }
+
+    std::sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) { return a.percent > b.percent; });
+    QStringList parts;
+    for (const Group& group : groups) {
+        if (parts.size() == 8) break;
+        QString name = QString::fromStdString(group.name);
+        if (group.threads > 1) name += QString("×%1").arg(group.threads);
+        parts << QString("%1 %2").arg(name).arg(group.percent, 0, 'f', 0);
+    }
+    return parts.join(", ");
+#else
+    Q_UNUSED(elapsedSec);
+    return QString();
+#endif
+}
+
+QString LinuxSystemMonitor::getSystemMemoryInfo()
+{
+#ifdef Q_OS_LINUX
+    char buffer[4096];
+    if (!readProc(m_meminfoFd, buffer, sizeof(buffer))) return "N/A";
+    const uint64_t totalKb = readKb(buffer, "MemTotal:");
+    const uint64_t availableKb = readKb(buffer, "MemAvailable:");
+    if (totalKb == 0) return "N/A";
+
+    double totalGB = totalKb / (1024.0 * 1024.0);
+    double usedGB = (totalKb - std::min(availableKb, totalKb)) / (1024.0 * 1024.0);
+    double usagePercent = 100.0 * usedGB / totalGB;
+    return QString("%1GB/%2GB (%3%)")
+           .arg(QString::number(usedGB, 'f', 1))
+           .arg(QString::number(totalGB, 'f', 1))
+           .arg(QString::number(usagePercent, 'f', 1));
+#else
+    return "N/A";
+#endif
+}
+
+QString LinuxSystemMonitor::getProcessMemoryInfo(uint64_t rssPages)
+{
+#ifdef Q_OS_LINUX
+    const auto now = std::chrono::steady_clock::now();
+    if (m_smapsFd >= 0 && now - m_lastPssRead >= std::chrono::seconds(1)) {
+        char buffer[4096];
+        if (readProc(m_smapsFd, buffer, sizeof(buffer))) m_pssMB = readKb(buffer, "\nPss:") / 1024.0;
+        m_lastPssRead = now;
+    }
+
+    double rssMB = rssPages * static_cast<double>(m_pageSize) / (1024.0 * 1024.0);
+    QString text = QString("%1MB RSS").arg(QString::number(rssMB, 'f', 1));
+    if (m_pssMB > 0.0) text += QString(" / %1MB PSS").arg(QString::number(m_pssMB, 'f', 1));
+    return text;
+#else
+    Q_UNUSED(rssPages);
+    return "N/A";
+#endif
+}
+
+QString LinuxSystemMonitor::getContextSwitches(double elapsedSec)
+{
+#ifdef Q_OS_LINUX
+    // getrusage sums every thread of the process in one call, unlike /proc/self/status
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return QString();
+    const uint64_t voluntary = static_cast<uint64_t>(usage.ru_nvcsw);
+    const uint64_t involuntary = static_cast<uint64_t>(usage.ru_nivcsw);
+    const double voluntaryRate = (voluntary - std::min(voluntary, m_lastVoluntary)) / elapsedSec;
+    const double involuntaryRate = (involuntary - std::min(involuntary, m_lastInvoluntary)) / elapsedSec;
+    m_lastVoluntary = voluntary;
+    m_lastInvoluntary = involuntary;
+    return QString("%1/s vol, %2/s invol")
+           .arg(QString::number(voluntaryRate, 'f', 0))
+           .arg(QString::number(involuntaryRate, 'f', 0));
+#else
+    Q_UNUSED(elapsedSec);
+    return QString();
+#endif
+}
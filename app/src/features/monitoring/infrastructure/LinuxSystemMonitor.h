@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ISystemMonitor.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief ISystemMonitor backed by procfs: process and per-thread CPU, RSS/PSS,
+ * system memory and context-switch rates.
+ *
+ * Every /proc file is opened once and re-read with pread(), and the task
+ * directory is rewound rather than reopened, so a poll costs a few syscalls per
+ * thread and is cheap enough for 10 Hz. smaps_rollup walks the page tables and
+ * is read at most once a second.
+ *
+ * Threads are labelled with their ThreadNames registration. Unregistered ones
+ * that carry a copied name (OpenVINO/TBB workers inherit their creator's) are
+ * counted as "runtime"; numbered pools ("scheduler-3", "ort-1") are summed.
+ */
+class LinuxSystemMonitor : public ISystemMonitor {
+public:
+    LinuxSystemMonitor();
+    ~LinuxSystemMonitor() override;
+
+    void initialize() override;
+    void cleanup() override;
+    SystemStats poll() override;
+
+private:
+    struct TaskSample {
+        int fd = -1;
+        uint64_t ticks = 0;
+        bool seen = false;
+    };
+
+    double  getCpuUsage(double elapsedSec, uint64_t& rssPages);
+    QString getThreadCpu(double elapsedSec);
+    QString getSystemMemoryInfo();
+    QString getProcessMemoryInfo(uint64_t rssPages);
+    QString getContextSwitches(double elapsedSec);
+
+#ifdef Q_OS_LINUX
+    void* m_taskDir = nullptr; // DIR*
+    int m_statFd = -1;
+    int m_meminfoFd = -1;
+    int m_smapsFd = -1;
+    std::unordered_map<long, TaskSample> m_tasks;
+    std::string m_processName;
+
+    uint64_t m_lastProcessTicks = 0;
+    uint64_t m_lastVoluntary = 0;
+    uint64_t m_lastInvoluntary = 0;
+    double m_pssMB = 0.0;
+    std::chrono::steady_clock::time_point m_lastPoll;
+    std::chrono::steady_clock::time_point m_lastPssRead;
+    long m_ticksPerSec = 100;
+    long m_pageSize = 4096;
+    int m_numProcessors = 1;
+#endif
+};
@@ -7,6 +7,7 @@
 #include <QtQml>
 #include <QQuickStyle>
 #include "shared/application/AppController.h"
+#include "shared/infrastructure/TaskScheduler.h"
 #include "features/camera/application/YoloCameraController.h"
 #include "features/monitoring/application/MonitoringController.h"
 #include "features/detection/application/DetectionController.h"
@@ -20,13 +21,20 @@
 
 int main(int argc, char *argv[])
 {
+    // OpenMP-based runtime builds size their pools from the environment; keep
+    // them inside the runtime share of the core budget
+    qputenv("OMP_NUM_THREADS", QByteArray::number(TaskScheduler::runtimeThreadBudget()));
+    qputenv("KMP_BLOCKTIME", "1");
+
     QGuiApplication app(argc, argv);
     QQuickStyle::setStyle("Basic");
     qRegisterMetaType<Detection>("Detection");
     qRegisterMetaType<YoloTask::TaskType>("YoloTask::TaskType");
     qRegisterMetaType<YoloTask::RuntimeType>("YoloTask::RuntimeType");
+    qRegisterMetaType<YoloTask::PerformanceHint>("YoloTask::PerformanceHint");
     qRegisterMetaType<std::vector<DetectionResult>>("std::vector<DetectionResult>");
     qRegisterMetaType<InferenceTiming>("InferenceTiming");
+    qRegisterMetaType<FrameTrace>("FrameTrace");
     qRegisterMetaType<InferenceConfig>("InferenceConfig");
     qRegisterMetaType<std::shared_ptr<cv::Mat>>("std::shared_ptr<cv::Mat>");
     qRegisterMetaType<std::shared_ptr<std::vector<DetectionResult>>>("std::shared_ptr<std::vector<DetectionResult>>");
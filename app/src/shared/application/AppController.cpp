@@ -1,14 +1,21 @@
 #include "AppController.h"
 #include <QQmlContext>
 #include <QTimer>
+#include "../domain/UiLogger.h"
+#include "../domain/AppConfig.h"
+#include "../infrastructure/FrameRing.h"
+#include "../infrastructure/TaskScheduler.h"
 
 // Monitoring
 #include "../../features/monitoring/infrastructure/WindowsSystemMonitor.h"
+#include "../../features/monitoring/infrastructure/LinuxSystemMonitor.h"
 #include "../../features/monitoring/application/SystemMonitorWorker.h"
 #include "../../features/monitoring/application/MonitoringController.h"
 
 // Detection
 #include "../../features/detection/infrastructure/YoloPipeline.h"
+#include "../../features/detection/infrastructure/SimdUtils.h"
+#include "../../features/detection/application/ModelRegistry.h"
 #include "../../features/detection/application/InferenceWorker.h"
 #include "../../features/detection/application/DetectionController.h"
 
@@ -29,6 +36,9 @@ AppController::~AppController()
 {
     if (m_captureWorker) m_captureWorker->stopCapturing();
     if (m_inferenceWorker) m_inferenceWorker->stopInference();
+
+    // No loader callbacks may post to the inference worker once its thread stops
+    if (m_modelRegistry) m_modelRegistry->shutdown();
     if (m_monitoringWorker) {
         QMetaObject::invokeMethod(m_monitoringWorker, "stop", Qt::BlockingQueuedConnection);
     }
@@ -40,6 +50,13 @@ AppController::~AppController()
     m_cameraThread.wait();
     m_inferenceThread.wait();
     m_monitoringThread.wait();
+
+    // Queued startInference/cancelModelLoad calls use the registry until the inference thread has finished
+    delete m_modelRegistry;
+    m_modelRegistry = nullptr;
+
+    delete m_frameRing;
+    m_frameRing = nullptr;
 }
 
 void AppController::initialize()
@@ -61,11 +78,16 @@ void AppController::initialize()
 
     // Start workers
     QMetaObject::invokeMethod(m_monitoringWorker, "start", Qt::QueuedConnection);
+    QMetaObject::invokeMethod(m_inferenceWorker, "run", Qt::QueuedConnection);
 }
 
 void AppController::setupMonitoring()
 {
+#ifdef Q_OS_LINUX
+    m_systemMonitorImpl = new LinuxSystemMonitor();
+#else
     m_systemMonitorImpl = new WindowsSystemMonitor();
+#endif
     m_monitoringWorker = new SystemMonitorWorker(m_systemMonitorImpl);
     m_monitoringController = new MonitoringController(m_monitoringWorker, this);
 
@@ -75,10 +97,23 @@ void AppController::setupMonitoring()
 
 void AppController::setupDetection()
 {
-    m_detectionModelImpl = new YoloPipeline();
-    m_inferenceWorker = new InferenceWorker(m_detectionModelImpl);
+    m_modelRegistry = new ModelRegistry([]() { return std::make_unique<YoloPipeline>(); },
+                                        static_cast<size_t>(AppConfig::ModelRegistryBudgetMB) * 1024 * 1024);
+    m_inferenceWorker = new InferenceWorker(m_modelRegistry);
     m_detectionController = new DetectionController(m_inferenceWorker, this);
 
+    QString isa = simd::isaName(simd::kernels().isa);
+    UiLogger::ctrl("AppController: SIMD kernels dispatched → " + isa);
+    m_detectionController->setSimdIsa(isa);
+
+    TaskScheduler& scheduler = TaskScheduler::global();
+    bool cvRouted = scheduler.installOpenCvBackend();
+    UiLogger::ctrl(QString("AppController: Scheduler → %1 workers + caller, runtimes get %2 of %3 threads%4")
+                   .arg(scheduler.workerCount())
+                   .arg(TaskScheduler::runtimeThreadBudget())
+                   .arg(TaskScheduler::coreBudget())
+                   .arg(cvRouted ? ", OpenCV routed" : ""));
+
     m_inferenceWorker->moveToThread(&m_inferenceThread);
     connect(&m_inferenceThread, &QThread::finished, m_inferenceWorker, &QObject::deleteLater);
 }
@@ -104,27 +139,64 @@ void AppController::wireEverything()
     connect(m_inferenceWorker, &InferenceWorker::detectionsReady, m_detectionController, &DetectionController::updateDetections);
     connect(m_detectionController, &DetectionController::requestModelChange, m_inferenceWorker, &InferenceWorker::startInference);
     connect(m_detectionController, &DetectionController::requestModelChange, m_captureWorker, &CaptureWorker::forceReinference);
+    connect(m_detectionController, &DetectionController::requestCancelModelLoad, m_inferenceWorker, &InferenceWorker::cancelModelLoad);
+    connect(m_inferenceWorker, &InferenceWorker::modelLoaded, m_detectionController, &DetectionController::onModelLoaded);
+    connect(m_inferenceWorker, &InferenceWorker::modelLoaded, m_captureWorker, &CaptureWorker::forceReinference);
+    connect(m_inferenceWorker, &InferenceWorker::modelLoadProgress, m_detectionController, &DetectionController::onModelLoadProgress);
+    connect(m_inferenceWorker, &InferenceWorker::modelLoadCancelled, m_detectionController, &DetectionController::onModelLoadCancelled);
+    connect(m_inferenceWorker, &InferenceWorker::stageStatsUpdated, m_detectionController, &DetectionController::onStageStatsUpdated);
+
+    // Once the first model is up, compile the other tasks in the background so switching is instant
+    connect(m_inferenceWorker, &InferenceWorker::modelLoaded, this, [this](YoloTask::TaskType task, YoloTask::RuntimeType runtime) {
+        if (!AppConfig::PrewarmModels || m_prewarmStarted) return;
+        m_prewarmStarted = true;
+
+        std::vector<InferenceConfig> configs;
+        for (auto other : {YoloTask::TaskType::ObjectDetection, YoloTask::TaskType::PoseEstimation, YoloTask::TaskType::ImageSegmentation}) {
+            if (other != task) configs.push_back(m_detectionController->configFor(other, runtime));
+        }
+        UiLogger::ctrl("AppController: Prewarming " + QString::number(configs.size()) + " sessions in background");
+        m_modelRegistry->prewarm(configs);
+    });
 
     // Capture (Common)
     connect(m_cameraController, &YoloCameraController::startCapture, m_captureWorker, &CaptureWorker::startCapturing);
     connect(m_cameraController, &YoloCameraController::stopCapture, m_captureWorker, &CaptureWorker::stopCapturing);
     connect(m_captureWorker, &CaptureWorker::fpsUpdated, m_cameraController, &YoloCameraController::updateFps);
+    connect(m_captureWorker, &CaptureWorker::framePoolStatsUpdated, m_cameraController, &YoloCameraController::updateFramePoolStats);
+    connect(m_captureWorker, &CaptureWorker::handoffStatsUpdated, m_cameraController, &YoloCameraController::updateHandoffStats);
     connect(m_captureWorker, &CaptureWorker::resolutionChanged, m_cameraController, &YoloCameraController::handleResolutionChanged);
 
     // Source Ready Requests
     connect(m_cameraController, &YoloCameraController::sourceReadyRequested, m_captureWorker, &CaptureWorker::setSource);
     connect(m_videoFileController, &VideoFileController::sourceReadyRequested, m_captureWorker, &CaptureWorker::setSource);
     connect(m_imageFileController, &ImageFileController::sourceReadyRequested, m_captureWorker, &CaptureWorker::setSource);
+
+    // Live and still sources want the shortest time per frame; offline video
+    // gets several OpenVINO streams for throughput
+    connect(m_cameraController, &YoloCameraController::sourceReadyRequested, m_detectionController, [this]() {
+        m_detectionController->setPerformanceHint(YoloTask::PerformanceHint::Latency);
+    });
+    connect(m_videoFileController, &VideoFileController::sourceReadyRequested, m_detectionController, [this]() {
+        m_detectionController->setPerformanceHint(YoloTask::PerformanceHint::Throughput);
+    });
+    connect(m_imageFileController, &ImageFileController::sourceReadyRequested, m_detectionController, [this]() {
+        m_detectionController->setPerformanceHint(YoloTask::PerformanceHint::Latency);
+    });
     
     // Video Playback Controls
     connect(m_captureWorker, &CaptureWorker::metadataUpdated, m_videoFileController, &VideoFileController::onMetadataUpdated);
     connect(m_captureWorker, &CaptureWorker::progressUpdated, m_videoFileController, &VideoFileController::onProgressUpdated);
     connect(m_videoFileController, &VideoFileController::requestSeek, m_captureWorker, &CaptureWorker::requestSeek);
 
-    // Cross-Feature
-    connect(m_captureWorker, &CaptureWorker::frameReady, m_inferenceWorker, &InferenceWorker::processFrame);
+    // Cross-Feature: frames go through the ring, not the event queue
+    auto handoff = static_cast<FrameRing::Policy>(AppConfig::FrameHandoffPolicy);
+    m_frameRing = new FrameRing(AppConfig::FrameRingSlots, handoff, std::chrono::milliseconds(AppConfig::MaxFrameAgeMs));
+    UiLogger::ctrl(QString("AppController: Frame hand-off policy → ") + FrameRing::policyName(handoff));
+    m_captureWorker->setFrameRing(m_frameRing);
+    m_inferenceWorker->setFrameRing(m_frameRing);
     connect(m_inferenceWorker, &InferenceWorker::latestDetectionsReady, m_captureWorker, &CaptureWorker::updateLatestDetections, Qt::DirectConnection);
-    m_captureWorker->setInferenceProcessingFlag(m_inferenceWorker->getProcessingFlag());
+    connect(m_captureWorker, &CaptureWorker::detectionsPresented, m_detectionController, &DetectionController::onDetectionsPresented);
 
     // Initial Model Load
     QTimer::singleShot(500, [this](){
@@ -11,7 +11,7 @@ class ISystemMonitor;
 
 class DetectionController;
 class InferenceWorker;
-class IDetectionModel;
+class ModelRegistry;
 
 class YoloCameraController;
 class VideoFileController;
@@ -19,6 +19,8 @@ class ImageFileController;
 class CaptureWorker;
 class ICaptureSource;
 
+class FrameRing;
+
 class AppController : public QObject {
     Q_OBJECT
 
@@ -38,7 +40,8 @@ private:
     QThread m_monitoringThread;
 
     // Detection Feature
-    IDetectionModel *m_detectionModelImpl;
+    ModelRegistry *m_modelRegistry = nullptr;
+    bool m_prewarmStarted = false;
     InferenceWorker *m_inferenceWorker;
     DetectionController *m_detectionController;
     QThread m_inferenceThread;
@@ -51,6 +54,9 @@ private:
     ImageFileController *m_imageFileController;
     QThread m_cameraThread;
 
+    // Capture -> inference frame hand-off
+    FrameRing *m_frameRing = nullptr;
+
     void setupMonitoring();
     void setupDetection();
     void setupCamera();
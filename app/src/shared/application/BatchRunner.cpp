@@ -0,0 +1,258 @@
+#include "BatchRunner.h"
+#include "../../features/camera/infrastructure/OpenCVImageFileSource.h"
+#include "../../features/camera/infrastructure/OpenCVVideoFileSource.h"
+#include "../../features/detection/infrastructure/YoloPipeline.h"
+#include "../infrastructure/BoundedQueue.h"
+#include "../infrastructure/ThreadNames.h"
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double msBetween(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // One decoded frame on its way to inference
+    struct DecodedFrame {
+        int64_t index = 0;
+        std::string source;
+        cv::Mat mat;
+        double decodeMs = 0.0;
+    };
+
+    // Frame of a request slot between submit and completion
+    struct SlotFrame {
+        int64_t index = 0;
+        std::string source;
+        Clock::time_point submitted;
+    };
+
+    struct Completed {
+        std::string source;
+        std::vector<DetectionResult> results;
+        InferenceTiming timing;
+    };
+}
+
+BatchRunner::BatchRunner(BatchOptions options)
+    : m_options(std::move(options))
+{
+}
+
+BatchRunner::~BatchRunner() = default;
+
+int BatchRunner::run()
+{
+    if (m_options.inputs.isEmpty()) {
+        std::cerr << "[Batch]: No inputs given." << std::endl;
+        return 2;
+    }
+
+    std::cerr << "[Batch]: Loading " << m_options.inference.modelPath << std::endl;
+    m_model = std::make_shared<YoloPipeline>();
+    if (const char* status = m_model->createSession(m_options.inference)) {
+        std::cerr << status << std::endl;
+        return 1;
+    }
+    std::cerr << "[Batch]: " << m_model->maxInFlight() << " requests in flight" << std::endl;
+
+    if (const char* status = m_writer.open(m_options.output.toStdString(), m_options.format)) {
+        std::cerr << status << std::endl;
+        return 1;
+    }
+
+    bool allOk = true;
+    const auto runStart = Clock::now();
+    for (const QString& input : m_options.inputs) {
+        allOk = processInput(input) && allOk;
+    }
+    const double runSeconds = msBetween(runStart, Clock::now()) / 1000.0;
+    m_writer.close();
+
+    if (m_options.inputs.size() > 1) printSummary("total", runSeconds, m_totals);
+    return allOk ? 0 : 1;
+}
+
+bool BatchRunner::processInput(const QString& input)
+{
+    const QFileInfo info(input);
+    QStringList images;
+    if (info.isDir()) {
+        images = imageFilesIn(input);
+        if (images.isEmpty()) {
+            std::cerr << "[Batch]: No images in " << input.toStdString() << std::endl;
+            return false;
+        }
+    } else if (isImageFile(input)) {
+        images << input;
+    }
+
+    std::unique_ptr<ICaptureSource> video;
+    if (images.isEmpty()) {
+        SourceConfig config;
+        config.sourceType = InputSourceType::VideoFile;
+        config.filePath = input;
+        config.loop = false;
+        config.realtime = false;
+        video = std::make_unique<OpenCVVideoFileSource>();
+        if (!video->open(config)) {
+            std::cerr << "[Batch]: Cannot open " << input.toStdString() << std::endl;
+            return false;
+        }
+    }
+
+    const int maxInFlight = std::max(1, m_model->maxInFlight());
+    BoundedQueue<DecodedFrame> frames(static_cast<size_t>(maxInFlight) * 2);
+    // Each slot completes at most once per submit, so pushes never block
+    BoundedQueue<int> completions(static_cast<size_t>(maxInFlight));
+
+    // Decode ahead while the runtime works; the queue bound keeps memory flat
+    std::thread decoder([&]() {
+        ThreadNames::setCurrent("decoder");
+        int64_t index = 0;
+        auto produce = [&](ICaptureSource& source, const std::string& name) {
+            DecodedFrame frame;
+            const auto start = Clock::now();
+            if (!source.readFrame(frame.mat) || frame.mat.empty()) return false;
+            frame.decodeMs = msBetween(start, Clock::now());
+            frame.index = index++;
+            frame.source = name;
+            return frames.push(std::move(frame));
+        };
+
+        if (video) {
+            const std::string name = input.toStdString();
+            while (produce(*video, name)) {}
+        } else {
+            OpenCVImageFileSource image;
+            for (const QString& path : images) {
+                SourceConfig config;
+                config.sourceType = InputSourceType::ImageFile;
+                config.filePath = path;
+                config.realtime = false;
+                if (!image.open(config)) continue;
+                if (!produce(image, path.toStdString())) break;
+            }
+        }
+        frames.close();
+    });
+
+    Latencies latencies;
+    std::vector<SlotFrame> slotFrames(static_cast<size_t>(maxInFlight));
+    std::map<int64_t, Completed> reorder;
+    int64_t nextToWrite = 0;
+    int inFlight = 0;
+    bool decoding = true;
+    bool ok = true;
+    const auto start = Clock::now();
+
+    while (true) {
+        while (decoding && inFlight < maxInFlight) {
+            DecodedFrame frame;
+            if (!frames.pop(frame)) {
+                decoding = false;
+                break;
+            }
+            const auto submitted = Clock::now();
+            const int slot = m_model->submitInference(frame.mat, [&completions](int done) {
+                completions.push(done);
+            });
+            if (slot < 0) {
+                std::cerr << "[Batch]: No free request slot; stopping " << input.toStdString() << std::endl;
+                decoding = false;
+                ok = false;
+                break;
+            }
+            slotFrames[slot] = {frame.index, std::move(frame.source), submitted};
+            latencies.decode.record(frame.decodeMs);
+            m_totals.decode.record(frame.decodeMs);
+            ++inFlight;
+        }
+        if (inFlight == 0) break;
+
+        int slot = -1;
+        if (!completions.pop(slot)) break;
+        Completed done;
+        const char* status = m_model->completeInference(slot, done.results, done.timing);
+        --inFlight;
+        if (status != nullptr) {
+            std::cerr << status << std::endl;
+            ok = false;
+        }
+
+        const double frameMs = msBetween(slotFrames[slot].submitted, Clock::now());
+        for (Latencies* set : {&latencies, &m_totals}) {
+            set->frame.record(frameMs);
+            set->pre.record(done.timing.preProcess);
+            set->infer.record(done.timing.inference);
+            set->post.record(done.timing.postProcess);
+        }
+
+        done.source = std::move(slotFrames[slot].source);
+        reorder.emplace(slotFrames[slot].index, std::move(done));
+        for (auto it = reorder.find(nextToWrite); it != reorder.end(); it = reorder.find(++nextToWrite)) {
+            m_writer.write(it->second.source, it->first, it->second.results, m_model->classNames(), it->second.timing);
+            reorder.erase(it);
+        }
+    }
+
+    frames.close();
+    decoder.join();
+
+    // A frame that never got a slot leaves a gap in the order; flush what is held
+    for (auto& entry : reorder) {
+        m_writer.write(entry.second.source, entry.first, entry.second.results, m_model->classNames(), entry.second.timing);
+    }
+
+    const double seconds = msBetween(start, Clock::now()) / 1000.0;
+    printSummary(info.fileName().isEmpty() ? input : info.fileName(), seconds, latencies);
+    return ok;
+}
+
+QStringList BatchRunner::imageFilesIn(const QString& directory)
+{
+    QDir dir(directory);
+    const QStringList names = dir.entryList({"*.jpg", "*.jpeg", "*.png", "*.bmp", "*.tif", "*.tiff", "*.webp"},
+                                            QDir::Files, QDir::Name | QDir::IgnoreCase);
+    QStringList paths;
+    for (const QString& name : names) paths << dir.filePath(name);
+    return paths;
+}
+
+bool BatchRunner::isImageFile(const QString& path)
+{
+    static const QStringList suffixes = {"jpg", "jpeg", "png", "bmp", "tif", "tiff", "webp"};
+    return suffixes.contains(QFileInfo(path).suffix().toLower());
+}
+
+void BatchRunner::printSummary(const QString& label, double seconds, Latencies& latencies)
+{
+    const std::pair<const char*, RollingLatency*> rows[] = {
+        {"frame", &latencies.frame}, {"decode", &latencies.decode},
+        {"pre", &latencies.pre}, {"infer", &latencies.infer}, {"post", &latencies.post},
+    };
+    for (const auto& row : rows) row.second->tick();
+
+    const uint64_t frames = latencies.frame.total().count;
+    char line[160];
+    std::snprintf(line, sizeof(line), "[Batch]: %s: %llu frames in %.2f s, %.1f FPS",
+                  label.toStdString().c_str(), static_cast<unsigned long long>(frames),
+                  seconds, seconds > 0.0 ? frames / seconds : 0.0);
+    std::cerr << line << std::endl;
+
+    for (const auto& row : rows) {
+        const RollingLatency::Summary summary = row.second->total();
+        if (summary.count == 0) continue;
+        std::snprintf(line, sizeof(line), "[Batch]:   %-6s p50 %7.2f  p90 %7.2f  p99 %7.2f  max %7.2f ms",
+                      row.first, summary.p50, summary.p90, summary.p99, summary.max);
+        std::cerr << line << std::endl;
+    }
+}
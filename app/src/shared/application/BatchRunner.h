@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include "../../features/detection/domain/InferenceConfig.h"
+#include "../../features/detection/infrastructure/DetectionWriter.h"
+#include "../infrastructure/LatencyHistogram.h"
+
+class IDetectionModel;
+
+struct BatchOptions {
+    InferenceConfig inference;
+    QStringList inputs;   // video files, image files or directories of images
+    QString output = "-"; // "-" writes to stdout
+    DetectionWriter::Format format = DetectionWriter::Format::JsonLines;
+};
+
+/**
+ * @brief Headless offline processing: runs every frame of the inputs through
+ * YoloPipeline as fast as the hardware allows and writes the detections.
+ *
+ * A decoder thread reads ahead into a bounded queue while the calling thread
+ * keeps up to maxInFlight() frames inside the runtime (all streams busy under
+ * the THROUGHPUT hint) and post-processes each as it completes. Completions can
+ * arrive out of order; results are written back in frame order.
+ *
+ * Throughput and per-stage latency are printed to stderr for every input and
+ * for the whole run.
+ */
+class BatchRunner {
+public:
+    explicit BatchRunner(BatchOptions options);
+    ~BatchRunner();
+
+    // Process exit code: 0 when every input was processed
+    int run();
+
+private:
+    struct Latencies {
+        RollingLatency frame{1};  // submit -> post-processed
+        RollingLatency decode{1};
+        RollingLatency pre{1};
+        RollingLatency infer{1};
+        RollingLatency post{1};
+    };
+
+    bool processInput(const QString& input);
+    static QStringList imageFilesIn(const QString& directory);
+    static bool isImageFile(const QString& path);
+    static void printSummary(const QString& label, double seconds, Latencies& latencies);
+
+    BatchOptions m_options;
+    std::shared_ptr<IDetectionModel> m_model;
+    DetectionWriter m_writer;
+    Latencies m_totals;
+};
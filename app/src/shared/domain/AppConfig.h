@@ -5,4 +5,50 @@ namespace AppConfig {
     static constexpr int FrameHeight = 480;
     static constexpr int ModelWidth  = 640;
     static constexpr int ModelHeight = 640;
+
+    // Compiled/optimized model cache, relative to the working directory like assets/
+    static constexpr const char* ModelCacheDir = "cache/models";
+
+    // Live sessions kept by ModelRegistry (estimated footprint), and whether the
+    // other tasks are compiled in the background after the first model loads
+    static constexpr int  ModelRegistryBudgetMB = 512;
+    static constexpr bool PrewarmModels         = true;
+
+    // Capture -> inference hand-off slots (minimum 3)
+    static constexpr int FrameRingSlots = 3;
+
+    // What happens to frames inference cannot keep up with (FrameRing::Policy):
+    // 0 latest wins, 1 bounded FIFO (every frame is inferred, capture waits),
+    // 2 frames older than MaxFrameAgeMs are dropped, 3 latest wins and the camera
+    // rate is lowered to what inference sustains (never below MinCaptureFps)
+    static constexpr int    FrameHandoffPolicy = 0;
+    static constexpr int    MaxFrameAgeMs      = 100;
+    static constexpr double MinCaptureFps      = 5.0;
+
+    // Pooled capture buffers: one being decoded, one per ring slot, plus slack
+    static constexpr int FramePoolSize = 6;
+
+    // Run pre-process, inference and post-process on separate threads. The queue
+    // between pre and infer holds StageQueueDepth slots; when full it blocks (0),
+    // drops the oldest (1) or drops the newest (2) prepared frame.
+    static constexpr bool StagedInference      = true;
+    static constexpr int  StageQueueDepth      = 2;
+    static constexpr int  StageQueueDropPolicy = 0;
+
+    // Workers of the shared task scheduler (0 = half the cores, minus the caller).
+    // The remaining cores go to the inference runtimes' own thread pools.
+    static constexpr int SchedulerWorkers = 0;
+
+    // Trace recording (builds with YOLOAPP_ENABLE_TRACING): events kept per
+    // thread before the oldest are overwritten, and where dumps are written
+    static constexpr int         TraceEventsPerThread = 65536;
+    static constexpr const char* TraceDir             = "traces";
+
+    // Latency histograms are published every LatencyPublishMs; the rolling
+    // window covers the last LatencyWindowSeconds of publishes
+    static constexpr int LatencyPublishMs     = 1000;
+    static constexpr int LatencyWindowSeconds = 60;
+
+    // System monitor poll period; the Linux monitor is cheap enough for 100 (10 Hz)
+    static constexpr int MonitorPollMs = 1000;
 }
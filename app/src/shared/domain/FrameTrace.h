@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Identity and hop timestamps of one captured frame, from the camera read
+ * until its detections are on screen.
+ *
+ * Travels by value with the frame (FrameRing slot, pipeline slot, InferenceTiming,
+ * overlay), each hop stamping its own entry. Timestamps are steady_clock
+ * nanoseconds; 0 means the hop was not reached.
+ */
+struct FrameTrace {
+    enum Hop {
+        Captured,       // decoded by CaptureWorker
+        Published,      // handed to the FrameRing
+        Dequeued,       // taken by inference
+        Prepared,       // preprocessed into a request slot
+        Inferred,       // runtime finished
+        PostProcessed,  // results decoded
+        Emitted,        // signalled to the GUI and overlay
+        Delivered,      // received by DetectionController
+        Presented,      // first display frame carrying these detections
+        HopCount
+    };
+
+    uint64_t frameId = 0;
+    std::array<int64_t, HopCount> hopNs{};
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void mark(Hop hop) { hopNs[hop] = now(); }
+    bool has(Hop hop) const { return hopNs[hop] != 0; }
+
+    // Milliseconds between two hops, negative if either is missing
+    double msBetween(Hop from, Hop to) const {
+        if (!has(from) || !has(to)) return -1.0;
+        return (hopNs[to] - hopNs[from]) / 1e6;
+    }
+};
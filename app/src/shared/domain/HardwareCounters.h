@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief CPU hardware event counts over some interval (see PerfCounters).
+ *
+ * `valid` is false when counters are compiled out or the kernel refused them;
+ * the counts are then zero.
+ */
+struct HardwareCounters {
+    uint64_t cycles       = 0;
+    uint64_t instructions = 0;
+    uint64_t llcMisses    = 0;
+    uint64_t branchMisses = 0;
+    bool     valid        = false;
+
+    double ipc() const { return cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0; }
+
+    // Counts between two readings of the same counters
+    HardwareCounters operator-(const HardwareCounters& earlier) const {
+        HardwareCounters delta;
+        delta.valid = valid && earlier.valid;
+        if (!delta.valid) return delta;
+        auto sub = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+        delta.cycles       = sub(cycles, earlier.cycles);
+        delta.instructions = sub(instructions, earlier.instructions);
+        delta.llcMisses    = sub(llcMisses, earlier.llcMisses);
+        delta.branchMisses = sub(branchMisses, earlier.branchMisses);
+        return delta;
+    }
+
+    // Counts of two disjoint sets of threads over the same interval
+    HardwareCounters operator+(const HardwareCounters& other) const {
+        HardwareCounters sum;
+        sum.valid = valid && other.valid;
+        if (!sum.valid) return sum;
+        sum.cycles       = cycles + other.cycles;
+        sum.instructions = instructions + other.instructions;
+        sum.llcMisses    = llcMisses + other.llcMisses;
+        sum.branchMisses = branchMisses + other.branchMisses;
+        return sum;
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// What push() does when the queue is full
+enum class QueueDropPolicy {
+    Block,       // wait for room (backpressure on the producer)
+    DropOldest,  // evict the item at the head
+    DropNewest   // refuse the item being pushed
+};
+
+/**
+ * @brief Fixed-capacity multi-producer/multi-consumer queue connecting pipeline stages.
+ *
+ * Items that do not make it through (evicted or refused) are handed back to the
+ * producer through push()'s `dropped` argument, so it can release whatever they own.
+ * close() wakes everyone: further pushes fail and pops drain what is left, then fail.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    struct Stats {
+        size_t capacity = 0;
+        size_t depth = 0;
+        size_t peakDepth = 0;
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        uint64_t dropped = 0;
+        double avgQueuedMs = 0.0; // time items spent queued
+    };
+
+    explicit BoundedQueue(size_t capacity, QueueDropPolicy policy = QueueDropPolicy::Block)
+        : m_capacity(std::max<size_t>(capacity, 1)), m_policy(policy) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Returns false once the queue is closed. If an item had to be dropped to honour
+    // the policy (the oldest one, or this one), it is moved into *dropped.
+    bool push(T item, std::optional<T>* dropped = nullptr) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_items.size() >= m_capacity && !m_closed) {
+            switch (m_policy) {
+            case QueueDropPolicy::Block:
+                m_notFull.wait(lock, [this]() { return m_items.size() < m_capacity || m_closed; });
+                break;
+            case QueueDropPolicy::DropOldest:
+                if (dropped) *dropped = std::move(m_items.front().item);
+                m_items.pop_front();
+                ++m_dropped;
+                break;
+            case QueueDropPolicy::DropNewest:
+                if (dropped) *dropped = std::move(item);
+                ++m_dropped;
+                return true;
+            }
+        }
+        if (m_closed) return false;
+
+        m_items.push_back({std::move(item), std::chrono::steady_clock::now()});
+        ++m_pushed;
+        m_peakDepth = std::max(m_peakDepth, m_items.size());
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is available; false when closed and drained.
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return !m_items.empty() || m_closed; });
+        return takeFront(lock, out);
+    }
+
+    // As pop(), but gives up after timeout.
+    bool pop(T& out, std::chrono::microseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait_for(lock, timeout, [this]() { return !m_items.empty() || m_closed; });
+        return takeFront(lock, out);
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+    // Empties and reopens the queue
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_items.clear();
+        m_closed = false;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats s;
+        s.capacity = m_capacity;
+        s.depth = m_items.size();
+        s.peakDepth = m_peakDepth;
+        s.pushed = m_pushed;
+        s.popped = m_popped;
+        s.dropped = m_dropped;
+        s.avgQueuedMs = m_popped ? m_queuedMsTotal / m_popped : 0.0;
+        return s;
+    }
+
+private:
+    struct Entry {
+        T item;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    bool takeFront(std::unique_lock<std::mutex>& lock, T& out) {
+        if (m_items.empty()) return false;
+        Entry& front = m_items.front();
+        m_queuedMsTotal += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - front.queuedAt).count();
+        out = std::move(front.item);
+        m_items.pop_front();
+        ++m_popped;
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    const size_t m_capacity;
+    const QueueDropPolicy m_policy;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Entry> m_items;
+    bool m_closed = false;
+
+    size_t m_peakDepth = 0;
+    uint64_t m_pushed = 0;
+    uint64_t m_popped = 0;
+    uint64_t m_dropped = 0;
+    double m_queuedMsTotal = 0.0;
+};
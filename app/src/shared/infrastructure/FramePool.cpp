@@ -0,0 +1,64 @@
+#include "FramePool.h"
+#include <algorithm>
+
+FramePool::FramePool(size_t capacity)
+    : m_shared(std::make_shared<Shared>())
+{
+    m_shared->buffers.resize(std::max<size_t>(capacity, 1));
+    for (int i = static_cast<int>(m_shared->buffers.size()) - 1; i >= 0; --i) {
+        m_shared->freeList.push_back(i);
+    }
+}
+
+FrameRef FramePool::acquire()
+{
+    m_shared->acquired.fetch_add(1, std::memory_order_relaxed);
+
+    int index = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        if (!m_shared->freeList.empty()) {
+            index = m_shared->freeList.back();
+            m_shared->freeList.pop_back();
+            int inUse = static_cast<int>(m_shared->buffers.size() - m_shared->freeList.size());
+            m_shared->peakInUse = std::max(m_shared->peakInUse, inUse);
+        }
+    }
+
+    if (index < 0) {
+        m_shared->starved.fetch_add(1, std::memory_order_relaxed);
+        return std::make_shared<cv::Mat>();
+    }
+
+    // The reference lends out the pool's own cv::Mat (the vector never resizes),
+    // so whatever the decoder allocates in it stays for the next use
+    std::shared_ptr<Shared> shared = m_shared;
+    cv::Mat* buffer = &shared->buffers[index];
+    return FrameRef(buffer, [shared, index](cv::Mat*) { shared->giveBack(index); });
+}
+
+void FramePool::Shared::giveBack(int index)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    freeList.push_back(index);
+}
+
+void FramePool::trim()
+{
+    std::lock_guard<std::mutex> lock(m_shared->mutex);
+    for (int index : m_shared->freeList) {
+        m_shared->buffers[index].release();
+    }
+}
+
+FramePool::Stats FramePool::stats() const
+{
+    Stats s;
+    std::lock_guard<std::mutex> lock(m_shared->mutex);
+    s.capacity = static_cast<int>(m_shared->buffers.size());
+    s.inUse = s.capacity - static_cast<int>(m_shared->freeList.size());
+    s.peakInUse = m_shared->peakInUse;
+    s.acquired = m_shared->acquired.load(std::memory_order_relaxed);
+    s.starved = m_shared->starved.load(std::memory_order_relaxed);
+    return s;
+}
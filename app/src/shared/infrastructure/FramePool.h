@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Reference-counted frame, shared by capture, inference and display
+ * without copying. Returns to its pool when the last reference goes away.
+ */
+using FrameRef = std::shared_ptr<cv::Mat>;
+
+/**
+ * @brief Fixed pool of reusable frame buffers that sources decode into.
+ *
+ * acquire() hands out a free buffer wrapped in a FrameRef. The buffer keeps its
+ * allocation between uses, so decoding a same-sized frame does not allocate. When
+ * every buffer is referenced the pool is starved: acquire() falls back to an
+ * unpooled frame and counts it, instead of blocking the capture loop.
+ *
+ * Pooled buffers must only be written while held through a single FrameRef;
+ * readers keep the FrameRef (not a shallow cv::Mat copy) for as long as they read.
+ */
+class FramePool {
+public:
+    struct Stats {
+        int capacity = 0;
+        int inUse = 0;
+        int peakInUse = 0;
+        uint64_t acquired = 0;
+        uint64_t starved = 0;   // acquires that found no free buffer
+    };
+
+    explicit FramePool(size_t capacity);
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    FrameRef acquire();
+
+    // Drops the cached allocations of free buffers, e.g. after a resolution change
+    void trim();
+
+    Stats stats() const;
+
+private:
+    // Outlives the pool while FrameRefs are still around
+    struct Shared {
+        std::mutex mutex;
+        std::vector<cv::Mat> buffers;
+        std::vector<int> freeList;
+        int peakInUse = 0;
+        std::atomic<uint64_t> acquired{0};
+        std::atomic<uint64_t> starved{0};
+
+        void giveBack(int index);
+    };
+
+    std::shared_ptr<Shared> m_shared;
+};
@@ -0,0 +1,200 @@
+#include "FrameRing.h"
+
+const char* FrameRing::policyName(Policy policy)
+{
+    switch (policy) {
+        case Policy::LatestWins:   return "latest-wins";
+        case Policy::BoundedFifo:  return "bounded FIFO";
+        case Policy::MaxAge:       return "max age";
+        case Policy::AdaptiveRate: return "adaptive rate";
+    }
+    return "unknown";
+}
+
+FrameRing::FrameRing(size_t slotCount, Policy policy, std::chrono::milliseconds maxAge)
+    : m_slots(slotCount < 3 ? 3 : slotCount)
+    , m_policy(policy)
+    , m_maxAge(maxAge)
+{
+}
+
+int FrameRing::claimFree()
+{
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        int expected = Free;
+        if (m_slots[i].state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int FrameRing::beginWrite()
+{
+    int slot = claimFree();
+    // Every frame must be read; the producer has to wait for the consumer
+    if (slot >= 0 || m_policy == Policy::BoundedFifo) return slot;
+
+    // Otherwise overwrite the oldest frame the consumer has not taken
+    while (true) {
+        int oldest = -1;
+        uint64_t oldestSeq = UINT64_MAX;
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].state.load(std::memory_order_acquire) == Ready) {
+                uint64_t seq = m_slots[i].seq.load(std::memory_order_relaxed);
+                if (seq < oldestSeq) {
+                    oldestSeq = seq;
+                    oldest = static_cast<int>(i);
+                }
+            } else {
+                // The consumer may have freed a slot since the first pass
+                int expected = Free;
+                if (m_slots[i].state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+                    return static_cast<int>(i);
+                }
+            }
+        }
+        if (oldest >= 0) {
+            int expected = Ready;
+            if (m_slots[oldest].state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return oldest;
+            }
+        }
+        // Lost a race with the consumer taking that slot; scan again
+    }
+}
+
+void FrameRing::waitForSpace(std::chrono::microseconds timeout)
+{
+    m_producerWaiting.store(true, std::memory_order_seq_cst);
+
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_spaceCv.wait_for(lock, timeout, [this]() {
+        for (const Slot& slot : m_slots) {
+            if (slot.state.load(std::memory_order_seq_cst) == Free) return true;
+        }
+        return false;
+    });
+    lock.unlock();
+
+    m_producerWaiting.store(false, std::memory_order_relaxed);
+}
+
+void FrameRing::publish(int slot)
+{
+    m_slots[slot].publishedAt = std::chrono::steady_clock::now();
+    m_slots[slot].seq.store(++m_writeSeq, std::memory_order_relaxed);
+    m_slots[slot].state.store(Ready, std::memory_order_release);
+
+    m_publishCount.fetch_add(1, std::memory_order_seq_cst);
+    if (m_consumerWaiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_waitCv.notify_one();
+    }
+}
+
+int FrameRing::findReady(bool newest) const
+{
+    int found = -1;
+    uint64_t foundSeq = 0;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].state.load(std::memory_order_acquire) != Ready) continue;
+        uint64_t seq = m_slots[i].seq.load(std::memory_order_relaxed);
+        if (seq <= m_lastReadSeq) continue;
+        if (found < 0 || (newest ? seq > foundSeq : seq < foundSeq)) {
+            foundSeq = seq;
+            found = static_cast<int>(i);
+        }
+    }
+    return found;
+}
+
+int FrameRing::tryAcquire()
+{
+    const bool inOrder = readsInOrder();
+    while (true) {
+        int slot = findReady(!inOrder);
+        if (slot < 0) return -1;
+
+        int expected = Ready;
+        if (!m_slots[slot].state.compare_exchange_strong(expected, Reading, std::memory_order_acquire)) {
+            continue; // producer reclaimed it for overwriting; a newer frame is on its way
+        }
+        const uint64_t seq = m_slots[slot].seq.load(std::memory_order_relaxed);
+        m_lastReadSeq = seq;
+
+        if (m_policy == Policy::MaxAge &&
+            std::chrono::steady_clock::now() - m_slots[slot].publishedAt > m_maxAge) {
+            freeSlot(slot);
+            m_stale.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (!inOrder) {
+            // Anything older is stale now; hand those slots back to the producer
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                if (static_cast<int>(i) == slot) continue;
+                if (m_slots[i].state.load(std::memory_order_acquire) == Ready &&
+                    m_slots[i].seq.load(std::memory_order_relaxed) < seq) {
+                    int ready = Ready;
+                    if (m_slots[i].state.compare_exchange_strong(ready, Reading, std::memory_order_acq_rel)) {
+                        freeSlot(static_cast<int>(i));
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+
+        m_consumed.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+}
+
+void FrameRing::release(int slot)
+{
+    freeSlot(slot);
+}
+
+void FrameRing::freeSlot(int slot)
+{
+    m_slots[slot].frame.reset();
+    m_slots[slot].state.store(Free, std::memory_order_seq_cst);
+    if (m_producerWaiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_spaceCv.notify_one();
+    }
+}
+
+void FrameRing::wait(std::chrono::microseconds timeout)
+{
+    m_consumerWaiting.store(true, std::memory_order_seq_cst);
+
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_waitCv.wait_for(lock, timeout, [this]() {
+        return m_publishCount.load(std::memory_order_seq_cst) != m_seenPublishCount ||
+               m_wakeRequested.load(std::memory_order_acquire);
+    });
+    lock.unlock();
+
+    m_consumerWaiting.store(false, std::memory_order_relaxed);
+    m_wakeRequested.store(false, std::memory_order_relaxed);
+    m_seenPublishCount = m_publishCount.load(std::memory_order_acquire);
+}
+
+void FrameRing::wake()
+{
+    m_wakeRequested.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(m_waitMutex);
+    m_waitCv.notify_one();
+}
+
+FrameRing::Stats FrameRing::stats() const
+{
+    Stats s;
+    s.published = m_publishCount.load(std::memory_order_relaxed);
+    s.consumed = m_consumed.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+    s.stale = m_stale.load(std::memory_order_relaxed);
+    return s;
+}
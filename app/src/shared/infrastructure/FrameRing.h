@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "FramePool.h"
+#include "../domain/FrameTrace.h"
+
+/**
+ * @brief Single-producer/single-consumer ring of frame slots between capture and inference.
+ *
+ * The producer (capture) claims a Free slot, stores a reference to the frame and
+ * publishes it; the consumer (inference) takes a published slot and releases it
+ * when done. What happens when the consumer falls behind depends on the Policy:
+ *
+ *  - LatestWins / AdaptiveRate: the consumer takes the newest frame, older unread
+ *    ones are dropped. AdaptiveRate additionally tells capture to lower its rate.
+ *  - BoundedFifo: frames are read oldest first and never dropped; beginWrite()
+ *    fails while all slots are taken and the producer waits in waitForSpace().
+ *  - MaxAge: frames are read oldest first, the producer overwrites the oldest when
+ *    full, and frames older than maxAge when read are discarded as stale.
+ *
+ * A slot gives up its frame reference when it is freed, so pooled buffers go back
+ * to the FramePool as soon as nobody reads them. Slot hand-over is lock-free
+ * through per-slot atomic states, each on its own cache line. The mutex/condition
+ * variables are only used to let an idle side sleep.
+ *
+ * At least three slots are needed so the producer always finds a slot while the
+ * consumer holds one and another is published.
+ */
+class FrameRing {
+public:
+    enum class Policy { LatestWins = 0, BoundedFifo = 1, MaxAge = 2, AdaptiveRate = 3 };
+    static const char* policyName(Policy policy);
+
+    struct Stats {
+        uint64_t published = 0;
+        uint64_t consumed = 0; // handed to inference
+        uint64_t dropped = 0;  // published but replaced before being read
+        uint64_t stale = 0;    // read too late (MaxAge) and discarded
+    };
+
+    explicit FrameRing(size_t slotCount = 3, Policy policy = Policy::LatestWins,
+                       std::chrono::milliseconds maxAge = std::chrono::milliseconds(0));
+
+    Policy policy() const { return m_policy; }
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // Producer. beginWrite() returns -1 only under BoundedFifo, when every slot is taken.
+    int beginWrite();
+    FrameRef& frame(int slot) { return m_slots[slot].frame; }
+    FrameTrace& trace(int slot) { return m_slots[slot].trace; }
+    void publish(int slot);
+    void waitForSpace(std::chrono::microseconds timeout);
+
+    // Consumer: the next slot to read according to the policy, or -1
+    int tryAcquire();
+    void release(int slot);
+    // Sleeps until something is published or wake() is called, at most timeout.
+    void wait(std::chrono::microseconds timeout);
+
+    // Wakes a waiting consumer, e.g. when it has other work (completions, stop)
+    void wake();
+
+    Stats stats() const;
+
+private:
+    enum State : int { Free = 0, Writing = 1, Ready = 2, Reading = 3 };
+
+    struct alignas(64) Slot {
+        std::atomic<int> state{Free};
+        std::atomic<uint64_t> seq{0};
+        std::chrono::steady_clock::time_point publishedAt;
+        FrameRef frame;
+        FrameTrace trace;
+    };
+
+    int claimFree();
+    int findReady(bool newest) const;
+    void freeSlot(int slot);
+    bool readsInOrder() const { return m_policy == Policy::BoundedFifo || m_policy == Policy::MaxAge; }
+
+    std::vector<Slot> m_slots;
+    const Policy m_policy;
+    const std::chrono::milliseconds m_maxAge;
+
+    alignas(64) std::atomic<uint64_t> m_publishCount{0};
+    std::atomic<uint64_t> m_dropped{0};
+    uint64_t m_writeSeq = 0;          // producer only
+
+    alignas(64) uint64_t m_lastReadSeq = 0; // consumer only
+    uint64_t m_seenPublishCount = 0;        // consumer only
+    std::atomic<uint64_t> m_consumed{0};
+    std::atomic<uint64_t> m_stale{0};
+
+    alignas(64) std::atomic<bool> m_consumerWaiting{false};
+    std::atomic<bool> m_wakeRequested{false};
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCv;
+
+    std::atomic<bool> m_producerWaiting{false};
+    std::condition_variable m_spaceCv;
+};
@@ -0,0 +1,127 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+int LatencyHistogram::bucketFor(uint64_t us)
+{
+    if (us < static_cast<uint64_t>(LinearBuckets)) return static_cast<int>(us);
+    us = std::min<uint64_t>(us, (uint64_t(1) << MaxValueBits) - 1);
+
+    int msb = 0;
+    while ((us >> (msb + 1)) != 0) ++msb;
+    const int shift = msb - SubBucketBits;
+    const int sub = static_cast<int>(us >> shift) - (1 << SubBucketBits);
+    return LinearBuckets + (msb - SubBucketBits - 1) * (1 << SubBucketBits) + sub;
+}
+
+double LatencyHistogram::bucketMs(int bucket)
+{
+    if (bucket < LinearBuckets) return bucket / 1000.0;
+
+    const int octave = (bucket - LinearBuckets) >> SubBucketBits;
+    const int sub = (bucket - LinearBuckets) & ((1 << SubBucketBits) - 1);
+    const int shift = octave + 1;
+    const uint64_t lower = static_cast<uint64_t>(sub + (1 << SubBucketBits)) << shift;
+    return (lower + (uint64_t(1) << shift) / 2.0) / 1000.0;
+}
+
+void LatencyHistogram::record(double ms)
+{
+    if (ms < 0.0) return;
+    const uint64_t us = static_cast<uint64_t>(std::llround(std::min(ms, 1e9) * 1000.0));
+    m_buckets[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t seen = m_maxUs.load(std::memory_order_relaxed);
+    while (us > seen && !m_maxUs.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {}
+}
+
+LatencyHistogram::Counts LatencyHistogram::drain()
+{
+    Counts counts;
+    for (int i = 0; i < BucketCount; ++i) {
+        if (m_buckets[i].load(std::memory_order_relaxed) == 0) continue;
+        const uint32_t n = m_buckets[i].exchange(0, std::memory_order_relaxed);
+        if (n == 0) continue;
+        counts.buckets.emplace_back(static_cast<uint16_t>(i), n);
+        counts.total += n;
+    }
+    counts.maxUs = m_maxUs.exchange(0, std::memory_order_relaxed);
+    return counts;
+}
+
+RollingLatency::RollingLatency(size_t intervals)
+    : m_capacity(std::max<size_t>(intervals, 1))
+    , m_windowCounts(LatencyHistogram::BucketCount, 0)
+    , m_totalCounts(LatencyHistogram::BucketCount, 0)
+{
+}
+
+void RollingLatency::setIntervals(size_t intervals)
+{
+    m_capacity = std::max<size_t>(intervals, 1);
+    reset();
+}
+
+void RollingLatency::tick()
+{
+    LatencyHistogram::Counts interval = m_live.drain();
+    for (const auto& bucket : interval.buckets) {
+        m_windowCounts[bucket.first] += bucket.second;
+        m_totalCounts[bucket.first] += bucket.second;
+    }
+    m_windowTotal += interval.total;
+    m_totalSamples += interval.total;
+    m_totalMaxUs = std::max(m_totalMaxUs, interval.maxUs);
+    m_intervals.push_back(std::move(interval));
+
+    if (m_intervals.size() > m_capacity) {
+        for (const auto& bucket : m_intervals.front().buckets) m_windowCounts[bucket.first] -= bucket.second;
+        m_windowTotal -= m_intervals.front().total;
+        m_intervals.pop_front();
+    }
+}
+
+void RollingLatency::reset()
+{
+    m_live.drain();
+    m_intervals.clear();
+    std::fill(m_windowCounts.begin(), m_windowCounts.end(), 0);
+    std::fill(m_totalCounts.begin(), m_totalCounts.end(), 0);
+    m_windowTotal = 0;
+    m_totalSamples = 0;
+    m_totalMaxUs = 0;
+}
+
+RollingLatency::Summary RollingLatency::window() const
+{
+    uint64_t maxUs = 0;
+    for (const auto& interval : m_intervals) maxUs = std::max(maxUs, interval.maxUs);
+    return summarize(m_windowCounts, m_windowTotal, maxUs);
+}
+
+RollingLatency::Summary RollingLatency::total() const
+{
+    return summarize(m_totalCounts, m_totalSamples, m_totalMaxUs);
+}
+
+RollingLatency::Summary RollingLatency::summarize(const std::vector<uint64_t>& counts, uint64_t total, uint64_t maxUs)
+{
+    Summary summary;
+    summary.count = total;
+    if (total == 0) return summary;
+    summary.max = maxUs / 1000.0;
+
+    // One pass over the buckets, filling each percentile as its rank is reached
+    const double percentiles[] = {50.0, 90.0, 95.0, 99.0};
+    double* outputs[] = {&summary.p50, &summary.p90, &summary.p95, &summary.p99};
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size() && next < 4; ++i) {
+        seen += counts[i];
+        while (next < 4 && seen >= std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentiles[next] / 100.0 * total)))) {
+            *outputs[next] = std::min(LatencyHistogram::bucketMs(static_cast<int>(i)), summary.max);
+            ++next;
+        }
+    }
+    return summary;
+}
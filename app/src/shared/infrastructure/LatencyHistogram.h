@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Log-linear (HDR-style) latency histogram with lock-free recording.
+ *
+ * Values are kept in whole microseconds up to ~134 s. Below 128 us every value
+ * has its own bucket; above that each power of two is split into 64 buckets, so
+ * a reported value is within 1.6% of what was recorded.
+ *
+ * record() may run on any number of threads at once (relaxed atomic adds).
+ * drain() hands the counts gathered since the previous drain to one reader.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SubBucketBits = 6;
+    static constexpr int MaxValueBits  = 27;
+    static constexpr int LinearBuckets = 2 << SubBucketBits;
+    static constexpr int BucketCount   = LinearBuckets + (MaxValueBits - SubBucketBits - 1) * (1 << SubBucketBits);
+
+    // Non-empty buckets of one drain
+    struct Counts {
+        std::vector<std::pair<uint16_t, uint32_t>> buckets;
+        uint64_t total = 0;
+        uint64_t maxUs = 0;
+    };
+
+    static int bucketFor(uint64_t us);
+    // Midpoint of a bucket, in milliseconds
+    static double bucketMs(int bucket);
+
+    // Negative values (hop not reached) are ignored
+    void record(double ms);
+    Counts drain();
+
+private:
+    std::array<std::atomic<uint32_t>, BucketCount> m_buckets{};
+    std::atomic<uint64_t> m_maxUs{0};
+};
+
+/**
+ * @brief LatencyHistogram summarised over a sliding window and since the last reset.
+ *
+ * Writers record() from any thread. tick() folds what arrived since the previous
+ * tick into the window and drops the oldest interval once `intervals` are held;
+ * it is meant to be called by one reader at a fixed rate, which also owns
+ * window(), total() and reset().
+ */
+class RollingLatency {
+public:
+    struct Summary {
+        uint64_t count = 0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    explicit RollingLatency(size_t intervals = 60);
+
+    // Window length in ticks; clears everything recorded
+    void setIntervals(size_t intervals);
+
+    void record(double ms) { m_live.record(ms); }
+
+    void tick();
+    void reset();
+
+    Summary window() const;
+    Summary total() const;
+    // Samples folded in by the latest tick
+    uint64_t lastIntervalCount() const { return m_intervals.empty() ? 0 : m_intervals.back().total; }
+
+private:
+    static Summary summarize(const std::vector<uint64_t>& counts, uint64_t total, uint64_t maxUs);
+
+    LatencyHistogram m_live;
+    size_t m_capacity;
+    std::deque<LatencyHistogram::Counts> m_intervals;
+    std::vector<uint64_t> m_windowCounts;
+    uint64_t m_windowTotal = 0;
+    std::vector<uint64_t> m_totalCounts;
+    uint64_t m_totalSamples = 0;
+    uint64_t m_totalMaxUs = 0;
+};
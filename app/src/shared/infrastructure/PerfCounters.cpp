@@ -0,0 +1,278 @@
+#include "PerfCounters.h"
+#include "ThreadNames.h"
+#include <QDebug>
+
+#if defined(YOLOAPP_ENABLE_PERF_COUNTERS) && defined(__linux__)
+#define YOLOAPP_PERF_EVENTS 1
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    struct EventSpec {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    // Order matches the HardwareCounters fields. The generic cache-miss event is
+    // the last-level cache on x86.
+    const EventSpec kEvents[] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+
+    int perfEventOpen(perf_event_attr& attr, long tid, int groupFd) {
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, static_cast<pid_t>(tid), -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    long currentTid() {
+        return static_cast<long>(syscall(SYS_gettid));
+    }
+
+    std::string readLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+}
+#endif
+
+PerfCounters& PerfCounters::instance()
+{
+    static PerfCounters* counters = new PerfCounters;
+    return *counters;
+}
+
+bool PerfCounters::available()
+{
+    return ensureOpen();
+}
+
+bool PerfCounters::ensureOpen()
+{
+    const int state = m_state.load(std::memory_order_acquire);
+    if (state != Untried) return state == Open;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state.load(std::memory_order_relaxed) != Untried) return m_state == Open;
+#ifdef YOLOAPP_PERF_EVENTS
+    // Probe on the calling thread; if that is refused every other thread would be too
+    ThreadGroup probe;
+    if (!openThread(currentTid(), probe)) {
+        const int error = errno;
+        const std::string paranoid = readLine("/proc/sys/kernel/perf_event_paranoid");
+        qDebug().nospace() << "[PerfCounters]: Hardware counters unavailable (" << std::strerror(error)
+                           << ", perf_event_paranoid=" << (paranoid.empty() ? "?" : paranoid.c_str()) << "); stage counters disabled";
+        m_state.store(Unavailable, std::memory_order_release);
+        return false;
+    }
+    closeThread(probe);
+    m_processName = readLine("/proc/self/comm");
+    qDebug() << "[PerfCounters]: Counting cycles, instructions, LLC and branch misses per stage";
+    m_state.store(Open, std::memory_order_release);
+    return true;
+#else
+    m_state.store(Unavailable, std::memory_order_release);
+    return false;
+#endif
+}
+
+HardwareCounters PerfCounters::readCurrentThread()
+{
+    if (!compiledIn() || !ensureOpen()) return HardwareCounters();
+#ifdef YOLOAPP_PERF_EVENTS
+    // Closed when the thread exits
+    struct Local {
+        ThreadGroup group;
+        bool opened = false;
+        ~Local() { closeThread(group); }
+    };
+    thread_local Local local;
+    if (!local.opened) {
+        local.opened = true;
+        openThread(currentTid(), local.group);
+    }
+    if (local.group.fds[0] < 0 || !readGroup(local.group)) return HardwareCounters();
+    return toCounters(local.group.last);
+#else
+    return HardwareCounters();
+#endif
+}
+
+HardwareCounters PerfCounters::readRuntimeThreads()
+{
+    if (!compiledIn() || !ensureOpen()) return HardwareCounters();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (std::chrono::steady_clock::now() - m_lastRefresh >= std::chrono::milliseconds(250)) refreshThreads();
+
+    uint64_t sums[EventCount];
+    for (int i = 0; i < EventCount; ++i) sums[i] = m_retired[i];
+    for (auto& entry : m_threads) {
+        readGroup(entry.second);
+        for (int i = 0; i < EventCount; ++i) sums[i] += entry.second.last[i];
+    }
+    return toCounters(sums);
+}
+
+void PerfCounters::enrollCurrentThread()
+{
+    if (!compiledIn() || !ensureOpen()) return;
+#ifdef YOLOAPP_PERF_EVENTS
+    // Folds the thread's final counts into the totals when it exits
+    struct Enrollment {
+        long tid = 0;
+        ~Enrollment() {
+            if (tid != 0) PerfCounters::instance().retireThread(tid);
+        }
+    };
+    thread_local Enrollment enrollment;
+    if (enrollment.tid != 0) return;
+
+    const long tid = currentTid();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_threads.find(tid);
+    if (it == m_threads.end()) {
+        ThreadGroup group;
+        if (!openThread(tid, group)) return;
+        it = m_threads.emplace(tid, group).first;
+    }
+    it->second.enrolled = true;
+    enrollment.tid = tid;
+#endif
+}
+
+void PerfCounters::refreshThreads()
+{
+    m_lastRefresh = std::chrono::steady_clock::now();
+#ifdef YOLOAPP_PERF_EVENTS
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return;
+
+    // Runtime-owned workers are unregistered threads that inherited the name of
+    // the process or of the app thread that created them
+    const long pid = static_cast<long>(getpid());
+    for (auto& entry : m_threads) entry.second.seen = false;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+        const long tid = std::strtol(entry->d_name, nullptr, 10);
+        auto it = m_threads.find(tid);
+        if (it != m_threads.end()) {
+            it->second.seen = true;
+            continue;
+        }
+        if (tid == pid || !ThreadNames::lookup(tid).empty()) continue;
+
+        const std::string comm = readLine("/proc/self/task/" + std::string(entry->d_name) + "/comm");
+        if (comm.empty() || (comm != m_processName && !ThreadNames::isRegisteredName(comm))) continue;
+        ThreadGroup group;
+        if (openThread(tid, group)) {
+            group.seen = true;
+            m_threads.emplace(tid, group);
+        }
+    }
+    closedir(dir);
+
+    for (auto it = m_threads.begin(); it != m_threads.end();) {
+        if (it->second.seen || it->second.enrolled) { ++it; continue; }
+        readGroup(it->second);
+        for (int i = 0; i < EventCount; ++i) m_retired[i] += it->second.last[i];
+        closeThread(it->second);
+        it = m_threads.erase(it);
+    }
+#endif
+}
+
+void PerfCounters::retireThread(long tid)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_threads.find(tid);
+    if (it == m_threads.end()) return;
+    readGroup(it->second);
+    for (int i = 0; i < EventCount; ++i) m_retired[i] += it->second.last[i];
+    closeThread(it->second);
+    m_threads.erase(it);
+}
+
+HardwareCounters PerfCounters::toCounters(const uint64_t* counts)
+{
+    HardwareCounters counters;
+    counters.cycles       = counts[0];
+    counters.instructions = counts[1];
+    counters.llcMisses    = counts[2];
+    counters.branchMisses = counts[3];
+    counters.valid        = true;
+    return counters;
+}
+
+bool PerfCounters::openThread(long tid, ThreadGroup& group)
+{
+#ifdef YOLOAPP_PERF_EVENTS
+    for (int i = 0; i < EventCount; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = kEvents[i].type;
+        attr.config = kEvents[i].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        group.fds[i] = perfEventOpen(attr, tid, i == 0 ? -1 : group.fds[0]);
+        if (group.fds[i] < 0) {
+            const int error = errno;
+            closeThread(group);
+            errno = error;
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)tid;
+    (void)group;
+    return false;
+#endif
+}
+
+bool PerfCounters::readGroup(ThreadGroup& group)
+{
+#ifdef YOLOAPP_PERF_EVENTS
+    struct {
+        uint64_t count;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+        uint64_t values[EventCount];
+    } data;
+    if (::read(group.fds[0], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) return false;
+    if (data.count != EventCount || data.timeRunning == 0) return false;
+
+    // Scale up when the PMU was shared with other groups (multiplexing)
+    const double scale = static_cast<double>(data.timeEnabled) / data.timeRunning;
+    for (int i = 0; i < EventCount; ++i) {
+        group.last[i] = static_cast<uint64_t>(data.values[i] * scale);
+    }
+    return true;
+#else
+    (void)group;
+    return false;
+#endif
+}
+
+void PerfCounters::closeThread(ThreadGroup& group)
+{
+#ifdef YOLOAPP_PERF_EVENTS
+    for (int& fd : group.fds) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+#else
+    (void)group;
+#endif
+}
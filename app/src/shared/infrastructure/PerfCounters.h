@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "../domain/HardwareCounters.h"
+
+/**
+ * @brief CPU cycles, instructions, LLC misses and branch misses per pipeline
+ * stage via perf_event_open (Linux, builds with YOLOAPP_ENABLE_PERF_COUNTERS).
+ *
+ * Counters are per thread and user space only, so they work under the default
+ * perf_event_paranoid=2. A stage reads only the threads that do its work:
+ *
+ * - readCurrentThread() is the calling thread's own group, opened on its first
+ *   call and read with one syscall and no lock. Pre- and post-processing take
+ *   the difference around the stage on the thread that runs it.
+ * - readRuntimeThreads() sums the enrolled pools: scheduler workers and runtime
+ *   threads call enrollCurrentThread() as they start. Workers that a runtime
+ *   starts itself (OpenVINO's TBB pool) carry a copied thread name and are
+ *   picked up from /proc/self/task at most every 250 ms. Inference uses this.
+ *
+ * Capture, UI and monitoring threads are never counted. Chunks that pre- and
+ * post-processing hand to scheduler workers through parallelFor count as
+ * inference work. Counts of exited pool threads are kept so readings never go
+ * backwards. If the kernel refuses the counters (paranoid level, container
+ * seccomp, no PMU) the first attempt logs why and every read returns an
+ * invalid sample.
+ */
+class PerfCounters {
+public:
+    static PerfCounters& instance();
+
+    static constexpr bool compiledIn() {
+#ifdef YOLOAPP_ENABLE_PERF_COUNTERS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool available();
+    HardwareCounters readCurrentThread();
+    HardwareCounters readRuntimeThreads();
+
+    // Adds the calling thread to readRuntimeThreads() until it exits
+    void enrollCurrentThread();
+
+private:
+    static constexpr int EventCount = 4;
+    enum State { Untried, Open, Unavailable };
+
+    struct ThreadGroup {
+        int fds[EventCount] = {-1, -1, -1, -1};
+        uint64_t last[EventCount] = {};
+        bool seen = false;
+        bool enrolled = false; // else found by its copied name and dropped once gone
+    };
+
+    // Never destroyed: pool threads retire themselves during static destruction
+    PerfCounters() = default;
+    bool ensureOpen();
+    void refreshThreads();
+    void retireThread(long tid);
+    static bool openThread(long tid, ThreadGroup& group);
+    static bool readGroup(ThreadGroup& group);
+    static void closeThread(ThreadGroup& group);
+    static HardwareCounters toCounters(const uint64_t* counts);
+
+    std::atomic<int> m_state{Untried};
+    std::mutex m_mutex;
+    std::unordered_map<long, ThreadGroup> m_threads;
+    uint64_t m_retired[EventCount] = {};
+    std::string m_processName;
+    std::chrono::steady_clock::time_point m_lastRefresh;
+};
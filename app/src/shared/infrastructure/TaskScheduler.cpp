@@ -0,0 +1,250 @@
+#include "TaskScheduler.h"
+#include "../domain/AppConfig.h"
+#include "ThreadNames.h"
+#include "PerfCounters.h"
+#include "Tracer.h"
+#include <algorithm>
+
+#if __has_include(<opencv2/core/parallel/parallel_backend.hpp>)
+#include <opencv2/core/parallel/parallel_backend.hpp>
+#define YOLOAPP_HAS_CV_PARALLEL_BACKEND 1
+#endif
+
+namespace {
+    thread_local const TaskScheduler* t_scheduler = nullptr;
+    thread_local int t_workerIndex = -1;
+
+    int defaultWorkerCount() {
+        if (AppConfig::SchedulerWorkers > 0) return AppConfig::SchedulerWorkers;
+        // Half the budget for app-side work, counting the thread that calls parallelFor
+        return std::max(1, TaskScheduler::coreBudget() / 2 - 1);
+    }
+
+#ifdef YOLOAPP_HAS_CV_PARALLEL_BACKEND
+    class OpenCvParallelBackend : public cv::parallel::ParallelForAPI {
+    public:
+        explicit OpenCvParallelBackend(TaskScheduler& scheduler) : m_scheduler(scheduler) {}
+
+        void parallel_for(int tasks, FN_parallel_for_body_cb_t body, void* data) override {
+            m_scheduler.parallelFor(0, tasks, 1, [body, data](int begin, int end) {
+                body(begin, end, data);
+            });
+        }
+        int getThreadNum() const override { return m_scheduler.currentWorker() + 1; }
+        int getNumThreads() const override { return m_scheduler.workerCount() + 1; }
+        int setNumThreads(int) override { return getNumThreads(); } // the budget is fixed
+        const char* getName() const override { return "yoloapp-scheduler"; }
+
+    private:
+        TaskScheduler& m_scheduler;
+    };
+#endif
+}
+
+TaskScheduler& TaskScheduler::global()
+{
+    static TaskScheduler scheduler(defaultWorkerCount());
+    return scheduler;
+}
+
+int TaskScheduler::coreBudget()
+{
+    return std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+int TaskScheduler::runtimeThreadBudget()
+{
+    return std::max(1, coreBudget() - (defaultWorkerCount() + 1));
+}
+
+TaskScheduler::TaskScheduler(int workerCount)
+    : m_utilizationSince(std::chrono::steady_clock::now())
+{
+    for (int i = 0; i < std::max(1, workerCount); ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < static_cast<int>(m_workers.size()); ++i) {
+        m_workers[i]->thread = std::thread(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_sleepCv.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+int TaskScheduler::currentWorker() const
+{
+    return t_scheduler == this ? t_workerIndex : -1;
+}
+
+void TaskScheduler::submit(Task task)
+{
+    // Workers keep their own tasks local (hot in cache); others spread round-robin
+    int self = currentWorker();
+    Worker& target = self >= 0
+        ? *m_workers[self]
+        : *m_workers[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCv.notify_one();
+}
+
+bool TaskScheduler::popTask(int self, Task& out)
+{
+    const int count = static_cast<int>(m_workers.size());
+    if (self >= 0) {
+        Worker& own = *m_workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker
+    const int start = self >= 0 ? self + 1 : static_cast<int>(m_nextQueue.load(std::memory_order_relaxed));
+    for (int k = 0; k < count; ++k) {
+        int victim = (start + k) % count;
+        if (victim == self) continue;
+        Worker& other = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            out = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::runOne(int self)
+{
+    Task task;
+    if (!popTask(self, task)) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    task();
+    if (self >= 0) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        m_workers[self]->busyNs.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void TaskScheduler::workerLoop(int index)
+{
+    t_scheduler = this;
+    t_workerIndex = index;
+    ThreadNames::setCurrent("scheduler-" + std::to_string(index));
+    PerfCounters::instance().enrollCurrentThread();
+
+    while (true) {
+        if (runOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCv.wait(lock, [this]() {
+            return m_stopping.load() || m_queued.load(std::memory_order_seq_cst) > 0;
+        });
+        if (m_stopping) break;
+    }
+}
+
+void TaskScheduler::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body)
+{
+    if (end <= begin) return;
+    grain = std::max(1, grain);
+    const int chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1) {
+        body(begin, end);
+        return;
+    }
+
+    // Helpers may start after this call returned; they find no chunk left and
+    // never touch `body`, but the shared counters must outlive the call.
+    struct State {
+        std::atomic<int> next{0};
+        std::atomic<int> done{0};
+    };
+    auto state = std::make_shared<State>();
+    const std::function<void(int, int)>* bodyPtr = &body;
+    auto runChunks = [state, bodyPtr, begin, end, grain, chunks]() {
+        int chunk;
+        while ((chunk = state->next.fetch_add(1, std::memory_order_relaxed)) < chunks) {
+            int chunkBegin = begin + chunk * grain;
+            (*bodyPtr)(chunkBegin, std::min(end, chunkBegin + grain));
+            state->done.fetch_add(1, std::memory_order_acq_rel);
+        }
+    };
+
+    const int helpers = std::min(chunks - 1, workerCount());
+    for (int i = 0; i < helpers; ++i) submit(runChunks);
+    runChunks();
+
+    const int self = currentWorker();
+    while (state->done.load(std::memory_order_acquire) < chunks) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+}
+
+bool TaskScheduler::installOpenCvBackend()
+{
+#ifdef YOLOAPP_HAS_CV_PARALLEL_BACKEND
+    cv::parallel::setParallelForBackend(std::make_shared<OpenCvParallelBackend>(*this), false);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void* TaskScheduler::startRuntimeThread(std::function<void()> loop, const std::string& name)
+{
+    const int index = m_runtimeThreads.fetch_add(1, std::memory_order_relaxed);
+    return new std::thread([loop = std::move(loop), name = name + "-" + std::to_string(index)]() {
+        ThreadNames::setCurrent(name);
+        PerfCounters::instance().enrollCurrentThread();
+        loop();
+    });
+}
+
+void TaskScheduler::joinRuntimeThread(void* handle)
+{
+    auto* thread = static_cast<std::thread*>(handle);
+    if (!thread) return;
+    if (thread->joinable()) thread->join();
+    delete thread;
+    m_runtimeThreads.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::vector<double> TaskScheduler::takeUtilization()
+{
+    std::lock_guard<std::mutex> lock(m_utilizationMutex);
+    auto now = std::chrono::steady_clock::now();
+    double elapsedNs = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_utilizationSince).count());
+    m_utilizationSince = now;
+
+    std::vector<double> load;
+    load.reserve(m_workers.size());
+    for (auto& worker : m_workers) {
+        uint64_t busy = worker->busyNs.exchange(0, std::memory_order_relaxed);
+        load.push_back(elapsedNs > 0 ? std::min(1.0, busy / elapsedNs) : 0.0);
+    }
+    return load;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide work-stealing scheduler that owns the CPU core budget.
+ *
+ * The budget (hardware threads) is split between the scheduler's workers, which
+ * run the app's own CPU work (preprocessing tiles, post-processing, masks, overlay
+ * blending, and OpenCV's internal parallel loops), and the inference runtimes,
+ * which get runtimeThreadBudget() threads for their own pools.
+ *
+ * Each worker owns a deque: it pushes and pops at the back, idle workers steal
+ * from the front of the others. Threads that wait on a parallelFor() help run
+ * queued tasks, so nested parallel loops cannot deadlock.
+ */
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    // Created on first use, sized from AppConfig::SchedulerWorkers
+    static TaskScheduler& global();
+
+    // Hardware threads available to the app, and the share left to inference runtimes
+    static int coreBudget();
+    static int runtimeThreadBudget();
+
+    explicit TaskScheduler(int workerCount);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    int workerCount() const { return static_cast<int>(m_workers.size()); }
+
+    void submit(Task task);
+
+    // Calls body(chunkBegin, chunkEnd) over [begin, end) in chunks of `grain`
+    // items, on the workers and the calling thread. Returns when all are done.
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body);
+
+    // Routes cv::parallel_for_ (resize, cvtColor, ...) onto this scheduler, when
+    // the OpenCV build supports pluggable parallel backends.
+    bool installOpenCvBackend();
+
+    // Dedicated threads for runtimes that insist on running their own worker
+    // loops (ONNX Runtime's intra-op pool); counted against the core budget.
+    void* startRuntimeThread(std::function<void()> loop, const std::string& name = "runtime");
+    void joinRuntimeThread(void* handle);
+    int runtimeThreadCount() const { return m_runtimeThreads.load(std::memory_order_relaxed); }
+
+    // Busy fraction [0, 1] of each worker since the previous call
+    std::vector<double> takeUtilization();
+
+    // Index of the calling worker, or -1 on other threads
+    int currentWorker() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+        std::atomic<uint64_t> busyNs{0};
+    };
+
+    void workerLoop(int index);
+    bool popTask(int self, Task& out);
+    bool runOne(int self);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<int> m_queued{0};
+    std::atomic<unsigned> m_nextQueue{0};
+    std::atomic<bool> m_stopping{false};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+
+    std::atomic<int> m_runtimeThreads{0};
+
+    std::mutex m_utilizationMutex;
+    std::chrono::steady_clock::time_point m_utilizationSince;
+};
@@ -0,0 +1,68 @@
+#include "ThreadNames.h"
+#include "Tracer.h"
+#include <mutex>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::mutex s_mutex;
+    std::unordered_map<long, std::string> s_names;
+
+    long currentTid() {
+#ifdef __linux__
+        return static_cast<long>(syscall(SYS_gettid));
+#else
+        return 0;
+#endif
+    }
+
+    std::string osName(const std::string& name) {
+        return name.substr(0, 15);
+    }
+
+    // Drops the registry entry when its thread exits, before the id can be reused
+    struct Registration {
+        long tid = 0;
+        ~Registration() {
+            if (tid == 0) return;
+            std::lock_guard<std::mutex> lock(s_mutex);
+            s_names.erase(tid);
+        }
+    };
+    thread_local Registration t_registration;
+}
+
+void ThreadNames::setCurrent(const std::string& name)
+{
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), osName(name).c_str());
+#endif
+    if (Tracer::compiledIn()) Tracer::instance().setThreadName(name);
+
+    const long tid = currentTid();
+    if (tid == 0) return;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_names[tid] = name;
+    t_registration.tid = tid;
+}
+
+std::string ThreadNames::lookup(long tid)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_names.find(tid);
+    return it != s_names.end() ? it->second : std::string();
+}
+
+bool ThreadNames::isRegisteredName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (const auto& entry : s_names) {
+        if (osName(entry.second) == name) return true;
+    }
+    return false;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief Names of the app's own threads, for the OS and for the system monitor.
+ *
+ * setCurrent() names the calling thread for the OS (top -H, perf, gdb; Linux
+ * keeps the first 15 bytes), for the tracer, and in a registry keyed by kernel
+ * thread id. The registry entry is removed when the thread exits.
+ *
+ * Threads started by third-party pools (OpenVINO's TBB workers) inherit the OS
+ * name of whichever thread created them; isRegisteredName() lets the monitor
+ * tell such copies apart from the thread that actually owns the name.
+ */
+class ThreadNames {
+public:
+    static void setCurrent(const std::string& name);
+
+    // Name registered by the thread with kernel id `tid`, empty if none
+    static std::string lookup(long tid);
+    static bool isRegisteredName(const std::string& name);
+};
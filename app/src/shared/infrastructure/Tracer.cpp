@@ -0,0 +1,193 @@
+#include "Tracer.h"
+#include "../domain/AppConfig.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+    void writeEscaped(std::ofstream& out, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+    }
+}
+
+Tracer::ThreadBuffer::ThreadBuffer(int id, size_t size)
+    : tid(id)
+    , capacity(size)
+    , events(new Event[size])
+{
+}
+
+Tracer& Tracer::instance()
+{
+    // Never destroyed: exiting threads hand their ring back during static destruction
+    static Tracer* tracer = new Tracer;
+    return *tracer;
+}
+
+Tracer::Tracer()
+{
+    const char* env = std::getenv("YOLOAPP_TRACE");
+    if (compiledIn() && env && env[0] == '1') m_enabled = true;
+}
+
+int64_t Tracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    m_enabled.store(compiledIn() && enabled, std::memory_order_relaxed);
+}
+
+Tracer::ThreadLocal& Tracer::threadLocal()
+{
+    thread_local ThreadLocal local;
+    return local;
+}
+
+Tracer::ThreadLocal::~ThreadLocal()
+{
+    if (buffer) Tracer::instance().releaseBuffer(buffer);
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer()
+{
+    ThreadLocal& local = threadLocal();
+    if (!local.buffer) {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        ThreadBuffer* buffer = nullptr;
+        if (!m_freeBuffers.empty()) {
+            // Drop the previous owner's events; the sequence check relies on stale
+            // slots never matching a new index
+            buffer = m_freeBuffers.back();
+            m_freeBuffers.pop_back();
+            for (size_t i = 0; i < buffer->capacity; ++i) buffer->events[i].seq.store(0, std::memory_order_relaxed);
+            buffer->head.store(0, std::memory_order_relaxed);
+            buffer->tid = ++m_nextTid;
+        } else {
+            m_buffers.push_back(std::make_unique<ThreadBuffer>(
+                ++m_nextTid, static_cast<size_t>(AppConfig::TraceEventsPerThread)));
+            buffer = m_buffers.back().get();
+        }
+        buffer->name = std::move(local.pendingName);
+        local.buffer = buffer;
+    }
+    return *local.buffer;
+}
+
+void Tracer::releaseBuffer(ThreadBuffer* buffer)
+{
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    m_freeBuffers.push_back(buffer);
+}
+
+void Tracer::record(const char* name, int64_t beginNs, int64_t endNs)
+{
+    ThreadBuffer& buffer = localBuffer();
+    const uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index % buffer.capacity];
+
+    event.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.beginNs.store(beginNs, std::memory_order_relaxed);
+    event.endNs.store(endNs, std::memory_order_relaxed);
+    event.seq.store(2 * index + 2, std::memory_order_release);
+
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const std::string& name)
+{
+    ThreadLocal& local = threadLocal();
+    if (!local.buffer) {
+        local.pendingName = name;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    local.buffer->name = name;
+}
+
+void Tracer::clear()
+{
+    m_clearedBeforeNs.store(nowNs(), std::memory_order_relaxed);
+}
+
+long long Tracer::dump(const std::string& path) const
+{
+    struct Copied {
+        int tid;
+        const char* name;
+        int64_t beginNs;
+        int64_t endNs;
+    };
+    std::vector<Copied> events;
+    std::vector<std::pair<int, std::string>> threads;
+    const int64_t clearedBefore = m_clearedBeforeNs.load(std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        for (const auto& buffer : m_buffers) {
+            threads.emplace_back(buffer->tid, buffer->name);
+
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const uint64_t first = head > buffer->capacity ? head - buffer->capacity : 0;
+            for (uint64_t i = first; i < head; ++i) {
+                const Event& event = buffer->events[i % buffer->capacity];
+                const uint64_t before = event.seq.load(std::memory_order_acquire);
+                Copied copy{buffer->tid,
+                            event.name.load(std::memory_order_relaxed),
+                            event.beginNs.load(std::memory_order_relaxed),
+                            event.endNs.load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t after = event.seq.load(std::memory_order_relaxed);
+
+                // Overwritten by a newer lap, or written while we read it
+                if (before != 2 * i + 2 || after != before || !copy.name) continue;
+                if (copy.beginNs < clearedBefore) continue;
+                events.push_back(copy);
+            }
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::path target(path);
+    if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), ec);
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return -1;
+
+    int64_t base = INT64_MAX;
+    for (const Copied& e : events) base = std::min(base, e.beginNs);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& thread : threads) {
+        if (thread.second.empty()) continue;
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread.first
+            << ",\"args\":{\"name\":\"";
+        writeEscaped(out, thread.second);
+        out << "\"}}";
+        first = false;
+    }
+    char times[64];
+    for (const Copied& e : events) {
+        std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f",
+                      (e.beginNs - base) / 1000.0, (e.endNs - e.beginNs) / 1000.0);
+        out << (first ? "" : ",\n") << "{\"ph\":\"X\",\"cat\":\"yolo\",\"name\":\"";
+        writeEscaped(out, e.name);
+        out << "\"," << times << ",\"pid\":1,\"tid\":" << e.tid << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+    out.close();
+    return out ? static_cast<long long>(events.size()) : -1;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Low-overhead begin/end event recorder with Chrome trace JSON export.
+ *
+ * Record sites use the YOLO_TRACE_* macros, which compile to nothing unless the
+ * build has YOLOAPP_ENABLE_TRACING. At runtime recording is off until
+ * setEnabled(true) (or YOLOAPP_TRACE=1 in the environment); a disabled site
+ * costs one relaxed load.
+ *
+ * Every thread writes into its own fixed-size ring of events without locks; the
+ * oldest events are overwritten once it is full. dump() may run concurrently
+ * with recording: each event carries a sequence number and torn or overwritten
+ * events are skipped. The mutex only guards the list of thread buffers.
+ *
+ * A thread gets its ring on its first recorded event, not before (a name set
+ * earlier is kept until then). When the thread exits the ring goes to a free
+ * list; its events stay in dumps until the next new thread takes it over, so
+ * restarted worker threads do not grow memory.
+ *
+ * The output loads in chrome://tracing and ui.perfetto.dev.
+ */
+class Tracer {
+public:
+    static Tracer& instance();
+
+    static constexpr bool compiledIn() {
+#ifdef YOLOAPP_ENABLE_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static int64_t nowNs();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // `name` must outlive the tracer (string literals)
+    void record(const char* name, int64_t beginNs, int64_t endNs);
+    void setThreadName(const std::string& name);
+
+    // Forgets everything recorded so far
+    void clear();
+
+    // Writes the recorded events as Chrome trace JSON; returns the number
+    // written, or -1 if the file could not be written
+    long long dump(const std::string& path) const;
+
+private:
+    struct Event {
+        std::atomic<uint64_t> seq{0};  // 2*index+1 while being written, 2*index+2 when complete
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> beginNs{0};
+        std::atomic<int64_t> endNs{0};
+    };
+
+    struct ThreadBuffer {
+        explicit ThreadBuffer(int id, size_t capacity);
+        int tid;
+        std::string name;             // guarded by m_buffersMutex
+        size_t capacity;
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t> head{0}; // written by the owning thread only
+    };
+
+    // The calling thread's ring, returned to the free list when the thread exits
+    struct ThreadLocal {
+        ThreadBuffer* buffer = nullptr;
+        std::string pendingName;
+        ~ThreadLocal();
+    };
+
+    Tracer();
+    static ThreadLocal& threadLocal();
+    ThreadBuffer& localBuffer();
+    void releaseBuffer(ThreadBuffer* buffer);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<int64_t> m_clearedBeforeNs{0};
+
+    mutable std::mutex m_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::vector<ThreadBuffer*> m_freeBuffers; // of exited threads, reused by new ones
+    int m_nextTid = 0;
+};
+
+/**
+ * @brief Records one complete event covering its own lifetime.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : m_name(Tracer::instance().isEnabled() ? name : nullptr)
+        , m_beginNs(m_name ? Tracer::nowNs() : 0)
+    {
+    }
+
+    ~TraceScope() {
+        if (m_name) Tracer::instance().record(m_name, m_beginNs, Tracer::nowNs());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_beginNs;
+};
+
+#define YOLO_TRACE_CONCAT_INNER(a, b) a##b
+#define YOLO_TRACE_CONCAT(a, b) YOLO_TRACE_CONCAT_INNER(a, b)
+
+#ifdef YOLOAPP_ENABLE_TRACING
+// Event spanning the rest of the enclosing block
+#define YOLO_TRACE_SCOPE(name) TraceScope YOLO_TRACE_CONCAT(yoloTraceScope_, __LINE__)(name)
+// Timestamp for an event finished elsewhere (async completions), 0 when disabled
+#define YOLO_TRACE_NOW() (Tracer::instance().isEnabled() ? Tracer::nowNs() : 0)
+#define YOLO_TRACE_COMPLETE(name, beginNs) \
+    do { if ((beginNs) != 0) Tracer::instance().record((name), (beginNs), Tracer::nowNs()); } while (0)
+#else
+#define YOLO_TRACE_SCOPE(name) do {} while (0)
+#define YOLO_TRACE_NOW() (int64_t(0))
+#define YOLO_TRACE_COMPLETE(name, beginNs) do { (void)(beginNs); } while (0)
+#endif
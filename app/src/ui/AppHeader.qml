@@ -109,6 +109,41 @@ RowLayout {
         onActivated: (index) => root.runtimeChanged(index)
     }
 
+    // Background model build; the previous model keeps running until it finishes
+    RowLayout {
+        visible: detectionController ? detectionController.modelLoading : false
+        spacing: 8
+
+        Text {
+            text: "Loading " + (detectionController ? Math.round(detectionController.modelLoadProgress * 100) : 0) + "%"
+            color: "#FFD600"
+            font.pixelSize: 12
+        }
+
+        Button {
+            id: cancelLoadBtn
+            text: "Cancel"
+            onClicked: detectionController.cancelModelLoad()
+
+            contentItem: Text {
+                text: cancelLoadBtn.text
+                color: "white"
+                font.pixelSize: 12
+                font.bold: true
+                horizontalAlignment: Text.AlignHCenter
+                verticalAlignment: Text.AlignVCenter
+            }
+
+            background: Rectangle {
+                implicitWidth: 64
+                implicitHeight: 32
+                color: cancelLoadBtn.hovered ? "#444444" : "#333333"
+                border.color: "#555555"
+                radius: 4
+            }
+        }
+    }
+
     Text { 
         text: "Res:"
         color: "white"
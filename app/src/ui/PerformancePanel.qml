@@ -1,5 +1,7 @@
 import QtQuick
 import QtQuick.Layouts
+import QtQuick.Controls
+import CameraModule 1.0
 
 Rectangle {
     id: root
@@ -41,6 +43,31 @@ Rectangle {
                 value: (inputMode === "image" || !detectionController) ? "-" : detectionController.inferenceFps.toFixed(1)
                 color: "#FF00FF"
             }
+            MetricItem {
+                label: "Frame Pool"
+                value: !cameraSource || cameraSource.framePoolSize === 0 ? "-"
+                       : cameraSource.framePoolPeak + "/" + cameraSource.framePoolSize
+                         + (cameraSource.framePoolStarved > 0 ? " (" + cameraSource.framePoolStarved + " starved)" : "")
+                color: "#00E5FF"
+            }
+            MetricItem {
+                label: "Frames"
+                value: !cameraSource || inputMode === "image" ? "-"
+                       : cameraSource.framesProcessed + " in / " + cameraSource.framesDropped + " drop"
+                         + (cameraSource.framesStale > 0 ? " / " + cameraSource.framesStale + " stale" : "")
+                         + (cameraSource.captureRateLimit > 0 ? " @" + cameraSource.captureRateLimit.toFixed(0) : "")
+                color: "#00E5FF"
+            }
+            MetricItem {
+                label: "SIMD"
+                value: detectionController && detectionController.simdIsa !== "" ? detectionController.simdIsa : "-"
+                color: "#00E5FF"
+            }
+            MetricItem {
+                label: "Hint"
+                value: !detectionController ? "-" : (detectionController.performanceHint === YoloTask.Throughput ? "Throughput" : "Latency")
+                color: "#00E5FF"
+            }
         }
 
         Rectangle { width: parent.width; height: 1; color: "#333333" }
@@ -56,9 +83,72 @@ Rectangle {
                 font.bold: true
             }
             
-            MetricItem { label: "Pre-Process"; value: detectionController ? detectionController.preProcessTime.toFixed(3) : "0.000"; color: "#76FF03" }
-            MetricItem { label: "Inference"; value: detectionController ? detectionController.inferenceTime.toFixed(3) : "0.000"; color: "#76FF03" }
-            MetricItem { label: "Post-Process"; value: detectionController ? detectionController.postProcessTime.toFixed(3) : "0.000"; color: "#76FF03" }
+            MetricItem { label: "Pre-Process p50"; value: detectionController ? detectionController.preProcessTime.toFixed(3) : "0.000"; color: "#76FF03" }
+            MetricItem { label: "Inference p50"; value: detectionController ? detectionController.inferenceTime.toFixed(3) : "0.000"; color: "#76FF03" }
+            MetricItem { label: "Post-Process p50"; value: detectionController ? detectionController.postProcessTime.toFixed(3) : "0.000"; color: "#76FF03" }
+            MetricItem {
+                label: "Capture→Det p50/95/99"
+                value: !detectionController || detectionController.captureToDetectionP50 === 0 ? "-"
+                       : detectionController.captureToDetectionP50.toFixed(1) + " / "
+                         + detectionController.captureToDetectionP95.toFixed(1) + " / "
+                         + detectionController.captureToDetectionP99.toFixed(1)
+                color: "#76FF03"
+            }
+            MetricItem {
+                label: "Glass→Glass p50/95/99"
+                value: !detectionController || detectionController.glassToGlassP50 === 0 ? "-"
+                       : detectionController.glassToGlassP50.toFixed(1) + " / "
+                         + detectionController.glassToGlassP95.toFixed(1) + " / "
+                         + detectionController.glassToGlassP99.toFixed(1)
+                color: "#76FF03"
+            }
+
+            // Histograms over the last minute: p50 / p90 / p99 / max
+            Column {
+                width: parent.width
+                visible: detectionController && detectionController.latencyStats.length > 0
+
+                Text {
+                    text: "stage         p50    p90    p99    max"
+                    color: "#888888"
+                    font.family: "Courier"
+                    font.pixelSize: 10
+                }
+
+                Repeater {
+                    model: detectionController ? detectionController.latencyStats : []
+
+                    Text {
+                        function cell(v) { return ("      " + v.toFixed(1)).slice(-7) }
+                        text: (modelData.name + "            ").slice(0, 11)
+                              + cell(modelData.p50) + cell(modelData.p90) + cell(modelData.p99) + cell(modelData.max)
+                        color: "#76FF03"
+                        font.family: "Courier"
+                        font.pixelSize: 10
+                    }
+                }
+            }
+
+            Text {
+                width: parent.width
+                visible: detectionController && detectionController.stageStats !== ""
+                text: detectionController ? detectionController.stageStats : ""
+                color: "#76FF03"
+                font.family: "Courier"
+                font.pixelSize: 10
+                wrapMode: Text.NoWrap
+            }
+
+            // Builds with YOLOAPP_ENABLE_PERF_COUNTERS, when the kernel allows them
+            Text {
+                width: parent.width
+                visible: detectionController && detectionController.hardwareCounters !== ""
+                text: detectionController ? detectionController.hardwareCounters : ""
+                color: "#76FF03"
+                font.family: "Courier"
+                font.pixelSize: 10
+                wrapMode: Text.NoWrap
+            }
         }
 
         Rectangle { width: parent.width; height: 1; color: "#333333" }
@@ -82,6 +172,58 @@ Rectangle {
                 font.pixelSize: 12
                 wrapMode: Text.Wrap
             }
+
+            // Trace capture, in builds with YOLOAPP_ENABLE_TRACING
+            Row {
+                visible: monitoringSource && monitoringSource.tracingAvailable
+                spacing: 8
+
+                Button {
+                    id: traceBtn
+                    text: monitoringSource && monitoringSource.tracingEnabled ? "Stop Trace" : "Start Trace"
+                    onClicked: monitoringSource.tracingEnabled = !monitoringSource.tracingEnabled
+
+                    contentItem: Text {
+                        text: traceBtn.text
+                        color: "white"
+                        font.pixelSize: 12
+                        font.bold: true
+                        horizontalAlignment: Text.AlignHCenter
+                        verticalAlignment: Text.AlignVCenter
+                    }
+
+                    background: Rectangle {
+                        implicitWidth: 90
+                        implicitHeight: 28
+                        color: traceBtn.hovered ? "#444444" : "#333333"
+                        border.color: monitoringSource && monitoringSource.tracingEnabled ? "#FF5252" : "#555555"
+                        radius: 4
+                    }
+                }
+
+                Button {
+                    id: dumpBtn
+                    text: "Dump"
+                    onClicked: monitoringSource.dumpTrace()
+
+                    contentItem: Text {
+                        text: dumpBtn.text
+                        color: "white"
+                        font.pixelSize: 12
+                        font.bold: true
+                        horizontalAlignment: Text.AlignHCenter
+                        verticalAlignment: Text.AlignVCenter
+                    }
+
+                    background: Rectangle {
+                        implicitWidth: 64
+                        implicitHeight: 28
+                        color: dumpBtn.hovered ? "#444444" : "#333333"
+                        border.color: "#555555"
+                        radius: 4
+                    }
+                }
+            }
         }
     }
 }